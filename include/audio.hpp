@@ -0,0 +1,255 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <array>
+#include <algorithm>
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL3_mixer/SDL_mixer.h>
+#include <JFLX/logging.hpp>
+
+/*
+++ Audio Engine
+Sound effects play on a fixed pool of AUDIO_VOICES tracks of the sound mixer instead of one new voice per MIX_PlayAudio:
+
+- play()   UI / player sounds, centered and at full gain
+- playAt() sounds at a world position (entities), attenuated with the distance to the listener and panned left / right,
+           a sound beyond AUDIO_MAXDISTANCE is dropped before it takes a voice
+- A full pool steals the voice with the lowest priority (then the quietest, then the oldest), a sound never steals
+  a voice of a higher priority, it is dropped instead
+- update() follows the listener (player): only the playing positional voices are recalculated, at most AUDIO_VOICES
+  per call. Call it once per rendered frame, not per simulation step, each voice costs a locked MIX_TrackPlaying
+
+Music uses two tracks of the music mixer, a new theme fades in on one while the old one fades out on the other (crossfade).
+*/
+static constexpr int AUDIO_VOICES         = 16;
+static constexpr float AUDIO_REFDISTANCE  = 128.0f;    // pixels, full gain up to this distance
+static constexpr float AUDIO_MAXDISTANCE  = 1024.0f;   // pixels, silent from this distance on
+static constexpr float AUDIO_PANDISTANCE  = 640.0f;    // pixels to the side for a sound only on one speaker
+static constexpr float AUDIO_GAINEPSILON  = 0.01f;     // smaller gain changes are not sent to the mixer
+static constexpr int AUDIO_FADEINMS       = 2000;
+static constexpr int AUDIO_CROSSFADEMS    = 3000;
+
+enum class SOUNDPRIORITY : uint8_t {
+    AMBIENT,
+    ENTITY,
+    PLAYER,
+    UI
+};
+
+class AudioEngine {
+public:
+    AudioEngine() = default;
+
+    ~AudioEngine() {
+        destroy();
+    }
+
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    //++ Creates the voice pool and the music tracks, returns false when a track could not be created
+    bool init(MIX_Mixer* soundMixer, MIX_Mixer* musicMixer) {
+        for (Voice& voice : voices) {
+            voice.track = MIX_CreateTrack(soundMixer);
+            if (!voice.track) {
+                JFLX::log("Audio: ", std::string("MIX_CreateTrack (SFX) failed: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                return false;
+            }
+        }
+        for (MIX_Track*& track : musicTracks) {
+            track = MIX_CreateTrack(musicMixer);
+            if (!track) {
+                JFLX::log("Audio: ", std::string("MIX_CreateTrack (Music) failed: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //++ Centered sound at full gain (UI, player)
+    bool play(MIX_Audio* audio, SOUNDPRIORITY priority, float gain = 1.0f) {
+        Voice* voice = acquire(priority, gain);
+        if (!voice) return false;
+
+        voice->positional = false;
+        voice->gain       = gain;
+        voice->baseGain   = gain;
+        MIX_SetTrackStereo(voice->track, nullptr);
+        return start(*voice, audio);
+    }
+
+    //++ Sound at world position x, y (pixels), dropped when it is too far away to be heard
+    bool playAt(MIX_Audio* audio, float x, float y, SOUNDPRIORITY priority, float gain = 1.0f) {
+        float audible = gain * attenuation(x, y);
+        if (audible <= 0.0f) return false;
+
+        Voice* voice = acquire(priority, audible);
+        if (!voice) return false;
+
+        voice->positional = true;
+        voice->x          = x;
+        voice->y          = y;
+        voice->baseGain   = gain;
+        applyPosition(*voice, true);
+        return start(*voice, audio);
+    }
+
+    //++ Listener position (center of the player), positional voices follow it on the next update()
+    void setListener(float x, float y) {
+        listenerX = x;
+        listenerY = y;
+    }
+
+    //++ Frees finished voices and recalculates the gain / pan of the playing positional voices, once per frame
+    void update() {
+        for (Voice& voice : voices) {
+            if (!voice.active) continue;
+            if (!MIX_TrackPlaying(voice.track)) {
+                voice.active = false;
+                continue;
+            }
+            if (voice.positional) applyPosition(voice, false);
+        }
+    }
+
+    //++ Playing voices of the pool
+    int activeVoices() const {
+        int count = 0;
+        for (const Voice& voice : voices) count += voice.active ? 1 : 0;
+        return count;
+    }
+
+    /*
+    ++ Crossfades to another music (looped)
+    Returns false when it is already playing or could not be started
+    */
+    bool playMusic(MIX_Audio* audio) {
+        MIX_Track* current = musicTracks[currentMusic];
+        if (!audio || !current) return false;
+        if (MIX_TrackPlaying(current) && MIX_GetTrackAudio(current) == audio) return false;
+
+        //-> The old music fades out on its track while the new one fades in on the other
+        if (MIX_TrackPlaying(current)) {
+            MIX_StopTrack(current, MIX_TrackMSToFrames(current, AUDIO_CROSSFADEMS));
+        }
+        currentMusic = (currentMusic + 1) % musicTracks.size();
+        MIX_Track* next = musicTracks[currentMusic];
+        MIX_StopTrack(next, 0);   // still fading out from the change before
+
+        if (!MIX_SetTrackAudio(next, audio)) {
+            JFLX::log("Audio: ", std::string("MIX_SetTrackAudio failed: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+
+        SDL_PropertiesID options = SDL_CreateProperties();
+        SDL_SetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
+        SDL_SetNumberProperty(options, MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER, AUDIO_FADEINMS);
+        bool played = MIX_PlayTrack(next, options);
+        SDL_DestroyProperties(options);
+
+        if (!played) {
+            JFLX::log("Audio: ", std::string("MIX_PlayTrack failed: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+        }
+        return played;
+    }
+
+    //++ Destroys every track (before the mixers are destroyed)
+    void destroy() {
+        for (Voice& voice : voices) {
+            if (voice.track) MIX_DestroyTrack(voice.track);
+            voice = {};
+        }
+        for (MIX_Track*& track : musicTracks) {
+            if (track) MIX_DestroyTrack(track);
+            track = nullptr;
+        }
+    }
+
+private:
+    struct Voice {
+        MIX_Track* track = nullptr;
+        SOUNDPRIORITY priority = SOUNDPRIORITY::AMBIENT;
+        uint64_t started  = 0;       // play order, the oldest voice is stolen first
+        bool active       = false;
+        bool positional   = false;
+        float x           = 0.0f;
+        float y           = 0.0f;
+        float baseGain    = 1.0f;
+        float gain        = 0.0f;    // gain sent to the mixer
+        float pan         = 0.0f;    // pan sent to the mixer, -1 left .. 1 right
+    };
+
+    std::array<Voice, AUDIO_VOICES> voices;
+    std::array<MIX_Track*, 2> musicTracks = {nullptr, nullptr};
+    size_t currentMusic = 0;
+    uint64_t playCounter = 0;
+    float listenerX = 0.0f;
+    float listenerY = 0.0f;
+
+    //-> Free voice, else the voice to steal, nullptr when every voice is more important than the new sound
+    Voice* acquire(SOUNDPRIORITY priority, float gain) {
+        Voice* best = nullptr;
+        for (Voice& voice : voices) {
+            if (!voice.track) continue;
+            if (!voice.active || !MIX_TrackPlaying(voice.track)) {
+                best = &voice;
+                break;
+            }
+            if (voice.priority > priority) continue;
+            if (!best || voice.priority < best->priority ||
+                (voice.priority == best->priority && (voice.gain < best->gain ||
+                (voice.gain == best->gain && voice.started < best->started)))) {
+                best = &voice;
+            }
+        }
+
+        //-> Same priority: a quieter sound does not replace a louder one
+        if (best && best->active && MIX_TrackPlaying(best->track) && best->priority == priority && best->gain > gain) return nullptr;
+
+        if (best) {
+            best->priority = priority;
+            best->started  = ++playCounter;
+        }
+        return best;
+    }
+
+    bool start(Voice& voice, MIX_Audio* audio) {
+        if (!MIX_SetTrackAudio(voice.track, audio) || !MIX_SetTrackGain(voice.track, voice.gain) || !MIX_PlayTrack(voice.track, 0)) {
+            JFLX::log("Audio: ", std::string("Failed to play sound: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+            voice.active = false;
+            return false;
+        }
+        voice.active = true;
+        return true;
+    }
+
+    //-> 1 up to AUDIO_REFDISTANCE, quadratic falloff to 0 at AUDIO_MAXDISTANCE
+    float attenuation(float x, float y) const {
+        float dx = x - listenerX, dy = y - listenerY;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        if (distance >= AUDIO_MAXDISTANCE) return 0.0f;
+        float t = std::clamp((distance - AUDIO_REFDISTANCE) / (AUDIO_MAXDISTANCE - AUDIO_REFDISTANCE), 0.0f, 1.0f);
+        return (1.0f - t) * (1.0f - t);
+    }
+
+    //-> Only changes above AUDIO_GAINEPSILON are sent to the mixer (each call locks the mixer)
+    void applyPosition(Voice& voice, bool force) {
+        float gain = voice.baseGain * attenuation(voice.x, voice.y);
+        float pan  = std::clamp((voice.x - listenerX) / AUDIO_PANDISTANCE, -1.0f, 1.0f);
+
+        if (force || std::fabs(gain - voice.gain) > AUDIO_GAINEPSILON) {
+            voice.gain = gain;
+            if (!force) MIX_SetTrackGain(voice.track, gain);
+        }
+        if (force || std::fabs(pan - voice.pan) > AUDIO_GAINEPSILON) {
+            voice.pan = pan;
+            //-> Centered both speakers play at full gain, to the side the far speaker fades out
+            MIX_StereoGains stereo = {std::min(1.0f, 1.0f - pan), std::min(1.0f, 1.0f + pan)};
+            MIX_SetTrackStereo(voice.track, &stereo);
+        }
+    }
+};
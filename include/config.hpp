@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <unordered_map>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+
+#include <nlohmann/json.hpp>
+#include <JFLX/logging.hpp>
+
+#include "fileWatcher.hpp"
+
+/*
+++ Typed Config
+settings.json, levelData.jsonc and progress.json are parsed once into the structs below, the game reads plain fields
+instead of looking up json keys. Comments are allowed in every file (.jsonc).
+
+Changed files are reloaded by a FileWatcher (fileWatcher.hpp) and handed to the main thread through a ConfigSlot.
+
+Parsing validates types and ranges: a wrong value is reported and keeps its default, a file that can not be parsed at all
+is rejected as a whole (the old config stays active).
+*/
+struct SettingsConfig {
+    int frameRate           = 144;
+    bool fullscreen         = false;
+    float renderQuality     = 1.0f;
+    bool dynamicResolution  = true;
+    int musicVolume         = 5;
+    int sfxVolume           = 100;
+};
+
+struct LevelConfig {
+    std::string wallName;
+    std::string theme;
+    std::string tileset;
+    std::vector<std::string> possibleEntities;   // "" = slot without entity
+    std::vector<std::string> possibleItems;      // "" = slot that stays empty
+    std::vector<std::string> exits;
+};
+
+struct LevelDataConfig {
+    std::unordered_map<std::string, LevelConfig> levels;
+
+    //++ nullptr when the level does not exist
+    const LevelConfig* find(const std::string& levelID) const {
+        auto it = levels.find(levelID);
+        return it != levels.end() ? &it->second : nullptr;
+    }
+};
+
+struct ProgressConfig {
+    std::string currentLevel = "0";
+    uint32_t worldSeed       = 12345;
+};
+
+using ConfigErrors = std::vector<std::string>;
+
+//++ Reads key into value when it exists and has the right type, else reports it and keeps the default
+template<typename T>
+void readConfigValue(const nlohmann::json& object, const std::string& key, T& value, ConfigErrors& errors) {
+    auto it = object.find(key);
+    if (it == object.end()) return;
+    try {
+        value = it->template get<T>();
+    } catch (const std::exception&) {
+        errors.push_back("\"" + key + "\" has the wrong type (" + it->type_name() + ")");
+    }
+}
+
+//++ Like readConfigValue, values outside of minValue .. maxValue are clamped
+template<typename T>
+void readConfigRange(const nlohmann::json& object, const std::string& key, T& value, T minValue, T maxValue, ConfigErrors& errors) {
+    readConfigValue(object, key, value, errors);
+    if (value < minValue || value > maxValue) {
+        errors.push_back("\"" + key + "\" is out of range, clamped");
+        value = std::clamp(value, minValue, maxValue);
+    }
+}
+
+inline bool parseSettings(const nlohmann::json& data, SettingsConfig& config, ConfigErrors& errors) {
+    if (!data.is_object()) {
+        errors.push_back("settings are not an object");
+        return false;
+    }
+    readConfigRange(data, "frameRate", config.frameRate, 1, 1000, errors);
+    readConfigValue(data, "fullscreen", config.fullscreen, errors);
+    readConfigRange(data, "renderQuality", config.renderQuality, 0.25f, 1.0f, errors);
+    readConfigValue(data, "dynamicResolution", config.dynamicResolution, errors);
+
+    auto volume = data.find("volume");
+    if (volume != data.end() && volume->is_object()) {
+        readConfigRange(*volume, "music", config.musicVolume, 0, 100, errors);
+        readConfigRange(*volume, "sfx", config.sfxVolume, 0, 100, errors);
+    } else if (volume != data.end()) {
+        errors.push_back("\"volume\" is not an object");
+    }
+    return true;
+}
+
+inline nlohmann::json settingsToJson(const SettingsConfig& config) {
+    return {
+        {"frameRate", config.frameRate},
+        {"fullscreen", config.fullscreen},
+        {"renderQuality", config.renderQuality},
+        {"dynamicResolution", config.dynamicResolution},
+        {"volume", {
+            {"music", config.musicVolume},
+            {"sfx", config.sfxVolume}
+        }}
+    };
+}
+
+inline bool parseLevelData(const nlohmann::json& data, LevelDataConfig& config, ConfigErrors& errors) {
+    if (!data.is_object()) {
+        errors.push_back("level data is not an object");
+        return false;
+    }
+    for (const auto& [levelID, entry] : data.items()) {
+        if (!entry.is_object()) {
+            errors.push_back("level " + levelID + " is not an object");
+            continue;
+        }
+        ConfigErrors levelErrors;
+        LevelConfig level;
+        readConfigValue(entry, "wallName", level.wallName, levelErrors);
+        readConfigValue(entry, "theme", level.theme, levelErrors);
+        readConfigValue(entry, "tileset", level.tileset, levelErrors);
+        readConfigValue(entry, "possibleEntities", level.possibleEntities, levelErrors);
+        readConfigValue(entry, "possibleItems", level.possibleItems, levelErrors);
+        readConfigValue(entry, "exits", level.exits, levelErrors);
+        if (level.tileset.empty()) levelErrors.push_back("\"tileset\" is missing");
+
+        for (const std::string& error : levelErrors) {
+            errors.push_back("level " + levelID + ": " + error);
+        }
+        config.levels[levelID] = std::move(level);
+    }
+    return true;
+}
+
+inline bool parseProgress(const nlohmann::json& data, ProgressConfig& config, ConfigErrors& errors) {
+    if (!data.is_object()) {
+        errors.push_back("progress is not an object");
+        return false;
+    }
+    readConfigValue(data, "currentLevel", config.currentLevel, errors);
+    readConfigValue(data, "worldSeed", config.worldSeed, errors);
+    return true;
+}
+
+/*
+++ Loads and parses a config file into config
+Returns false (config untouched) when the file is missing, no valid json or rejected by the parser,
+value errors are logged but the file is accepted
+*/
+template<typename T>
+bool loadConfig(const std::string& filePath, T& config, bool (*parser)(const nlohmann::json&, T&, ConfigErrors&)) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        JFLX::log("Config: ", "Failed to open " + filePath, JFLX::LOGTYPE::WARNING);
+        return false;
+    }
+
+    T parsed;
+    ConfigErrors errors;
+    try {
+        nlohmann::json data = nlohmann::json::parse(file, nullptr, true, true); //-> allow comments (.jsonc)
+        if (!parser(data, parsed, errors)) {
+            for (const std::string& error : errors) JFLX::log("Config: ", filePath + ": " + error, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+    } catch (const std::exception& e) {
+        JFLX::log("Config: ", "Invalid json in " + filePath + ": " + e.what(), JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+
+    for (const std::string& error : errors) JFLX::log("Config: ", filePath + ": " + error, JFLX::LOGTYPE::WARNING);
+    config = std::move(parsed);
+    return true;
+}
+
+/*
+++ Config Slot
+Hands a config parsed on the watcher thread to the main thread. publish() replaces the pending config, take() returns it
+once on the main thread, which swaps it in at the start of a frame: a config is never changed while it is read.
+*/
+template<typename T>
+class ConfigSlot {
+public:
+    void publish(std::shared_ptr<const T> config) {
+        std::lock_guard<std::mutex> lock(mutex);
+        latest = std::move(config);
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    bool pending() const {
+        return version.load(std::memory_order_acquire) != taken;
+    }
+
+    //++ The newest config when it changed since the last take(), else nullptr
+    std::shared_ptr<const T> take() {
+        if (!pending()) return nullptr;
+        std::lock_guard<std::mutex> lock(mutex);
+        taken = version.load(std::memory_order_relaxed);
+        return latest;
+    }
+
+private:
+    std::mutex mutex;
+    std::shared_ptr<const T> latest;
+    std::atomic<uint32_t> version{0};
+    uint32_t taken = 0;
+};
@@ -0,0 +1,506 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include <SDL3/SDL.h>
+
+#include "room.hpp"
+#include "tileCollision.hpp"
+#include "pathfinding.hpp"
+#include "textureStore.hpp"
+
+/*
+++ Entities
+Level entities (Smilers, later items lying around) live in an EntityStore instead of single globals like the Player.
+
+- Entity:   handle of id + generation, a handle of a destroyed entity never resolves to its successor
+- Core:     position, velocity and type of every living entity in dense arrays (structure of arrays), swap removed,
+            the movement / render systems walk them front to back without any indirection
+- Optional: components only some entities have (Wander, PathFollower) live in ComponentArray, a sparse set
+            with its own dense array, systems walk that array and reach the core arrays by one index
+- Spatial:  every entity is listed in the bucket of the chunk its center is in, buckets are updated only
+            when an entity crosses a chunk border, proximity queries only visit the buckets of the chunks they touch
+*/
+struct Entity {
+    uint32_t id         = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& other) const {
+        return id == other.id && generation == other.generation;
+    }
+};
+
+static constexpr Entity NOENTITY = {};
+
+//-> Entities Based on: https://backrooms-wiki.wikidot.com/entities
+enum class ENTITYTYPE : uint8_t {
+    SMILER,
+
+    Count,
+    UNKNOWN = UINT8_MAX
+};
+
+struct EntityTypeInfo {
+    std::string_view name;      // name in levelData "possibleEntities"
+    std::string_view texture;   // textureMap name
+    std::string_view sound;     // soundMap name, played where the entity starts to hunt
+    float width;
+    float height;
+    float speed;                // pixels per second
+    bool hunts;                 // follows the player (PathFollower) when it comes close
+};
+
+static constexpr EntityTypeInfo ENTITYTYPES[] = {
+    {"Smillers", "smiler", "smiler", 48.0f, 48.0f, 96.0f, true},
+};
+static_assert(std::size(ENTITYTYPES) == size_t(ENTITYTYPE::Count), "ENTITYTYPES needs an entry for every ENTITYTYPE");
+
+inline ENTITYTYPE getEntityType(std::string_view name) {
+    for (size_t i = 0; i < std::size(ENTITYTYPES); ++i) {
+        if (ENTITYTYPES[i].name == name) return ENTITYTYPE(i);
+    }
+    return ENTITYTYPE::UNKNOWN;
+}
+
+inline const EntityTypeInfo& entityTypeInfo(ENTITYTYPE type) {
+    return ENTITYTYPES[size_t(type)];
+}
+
+/*
+++ Sparse Set of one optional component
+data / owners are dense (owners[i] = entity id of data[i]), sparse maps an entity id to its dense index.
+*/
+template <typename T>
+class ComponentArray {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    std::vector<T> data;
+    std::vector<uint32_t> owners;
+
+    T& add(uint32_t id, const T& value) {
+        if (id >= sparse.size()) sparse.resize(size_t(id) + 1, NONE);
+        if (sparse[id] != NONE) return data[sparse[id]] = value;
+
+        sparse[id] = uint32_t(data.size());
+        data.push_back(value);
+        owners.push_back(id);
+        return data.back();
+    }
+
+    void remove(uint32_t id) {
+        if (id >= sparse.size() || sparse[id] == NONE) return;
+
+        uint32_t index = sparse[id];
+        uint32_t last  = uint32_t(data.size() - 1);
+        if (index != last) {
+            data[index]   = std::move(data[last]);
+            owners[index] = owners[last];
+            sparse[owners[index]] = index;
+        }
+        data.pop_back();
+        owners.pop_back();
+        sparse[id] = NONE;
+    }
+
+    T* get(uint32_t id) {
+        if (id >= sparse.size() || sparse[id] == NONE) return nullptr;
+        return &data[sparse[id]];
+    }
+
+    size_t size() const {
+        return data.size();
+    }
+
+private:
+    std::vector<uint32_t> sparse;
+};
+
+//++ Walks into a random direction, picks a new one (or stands still) when the timer runs out
+struct Wander {
+    float timer   = 0.0f;
+    uint32_t rng  = 1;
+};
+
+//++ Walks along a path of tiles from the PathService, overrides Wander while it has a path
+struct PathFollower {
+    std::vector<std::array<int, 2>> path;
+    size_t next = 0;
+    float repathTimer = 0.0f;
+};
+
+class EntityStore {
+public:
+    //++ Core arrays, index = dense index (not the entity id)
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<ENTITYTYPE> type;
+    std::vector<uint32_t> ids;   // entity id of the dense index
+
+    ComponentArray<Wander> wanders;
+    ComponentArray<PathFollower> followers;
+
+    Entity create(ENTITYTYPE entityType, float worldX, float worldY) {
+        uint32_t id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+        } else {
+            id = uint32_t(slots.size());
+            slots.push_back({});
+        }
+
+        uint32_t index = uint32_t(ids.size());
+        x.push_back(worldX);
+        y.push_back(worldY);
+        vx.push_back(0.0f);
+        vy.push_back(0.0f);
+        type.push_back(entityType);
+        ids.push_back(id);
+        chunk.push_back(chunkOf(index));
+        bucketSlot.push_back(0);
+
+        slots[id].dense = index;
+        addToBucket(index);
+        return {id, slots[id].generation};
+    }
+
+    void destroy(Entity entity) {
+        if (!alive(entity)) return;
+
+        uint32_t index = slots[entity.id].dense;
+        uint32_t last  = uint32_t(ids.size() - 1);
+        removeFromBucket(index);
+        wanders.remove(entity.id);
+        followers.remove(entity.id);
+
+        if (index != last) {
+            moveDense(last, index);
+        }
+        x.pop_back();
+        y.pop_back();
+        vx.pop_back();
+        vy.pop_back();
+        type.pop_back();
+        ids.pop_back();
+        chunk.pop_back();
+        bucketSlot.pop_back();
+
+        slots[entity.id].dense = NONE;
+        slots[entity.id].generation++;
+        freeIds.push_back(entity.id);
+    }
+
+    void clear() {
+        while (!ids.empty()) {
+            uint32_t id = ids.back();
+            destroy({id, slots[id].generation});
+        }
+        buckets.clear();
+    }
+
+    bool alive(Entity entity) const {
+        return entity.id < slots.size() && slots[entity.id].generation == entity.generation && slots[entity.id].dense != NONE;
+    }
+
+    //++ Dense index of a living entity id
+    uint32_t indexOf(uint32_t id) const {
+        return slots[id].dense;
+    }
+
+    uint32_t generationOf(uint32_t id) const {
+        return slots[id].generation;
+    }
+
+    size_t size() const {
+        return ids.size();
+    }
+
+    //++ Has to be called after x / y of the dense index changed, moves it to another bucket when it crossed a chunk border
+    void moved(uint32_t index) {
+        int64_t key = chunkOf(index);
+        if (key == chunk[index]) return;
+
+        removeFromBucket(index);
+        chunk[index] = key;
+        addToBucket(index);
+    }
+
+    //++ Dense indices of the entities in the chunk (valid until the next create / destroy / moved)
+    const std::vector<uint32_t>* inChunk(int chunkX, int chunkY) const {
+        auto it = buckets.find(packChunk(chunkX, chunkY));
+        return it != buckets.end() && !it->second.empty() ? &it->second : nullptr;
+    }
+
+    //++ Appends the dense indices of every entity whose center is within radius of (worldX, worldY)
+    void queryRadius(float worldX, float worldY, float radius, std::vector<uint32_t>& out) const {
+        float radius2 = radius * radius;
+        for (int cy = worldToChunk(worldY - radius); cy <= worldToChunk(worldY + radius); ++cy) {
+            for (int cx = worldToChunk(worldX - radius); cx <= worldToChunk(worldX + radius); ++cx) {
+                const std::vector<uint32_t>* bucket = inChunk(cx, cy);
+                if (!bucket) continue;
+                for (uint32_t index : *bucket) {
+                    float dx = centerX(index) - worldX;
+                    float dy = centerY(index) - worldY;
+                    if (dx * dx + dy * dy <= radius2) out.push_back(index);
+                }
+            }
+        }
+    }
+
+    float centerX(uint32_t index) const {
+        return x[index] + entityTypeInfo(type[index]).width * 0.5f;
+    }
+
+    float centerY(uint32_t index) const {
+        return y[index] + entityTypeInfo(type[index]).height * 0.5f;
+    }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Slot {
+        uint32_t dense      = NONE;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeIds;
+
+    //++ Spatial hash, parallel to the core arrays: bucket key and position inside the bucket
+    std::vector<int64_t> chunk;
+    std::vector<uint32_t> bucketSlot;
+    std::unordered_map<int64_t, std::vector<uint32_t>> buckets;
+
+    static int64_t packChunk(int chunkX, int chunkY) {
+        return (int64_t(chunkX) << 32) | uint32_t(chunkY);
+    }
+
+    int64_t chunkOf(uint32_t index) const {
+        return packChunk(worldToChunk(centerX(index)), worldToChunk(centerY(index)));
+    }
+
+    void addToBucket(uint32_t index) {
+        std::vector<uint32_t>& bucket = buckets[chunk[index]];
+        bucketSlot[index] = uint32_t(bucket.size());
+        bucket.push_back(index);
+    }
+
+    void removeFromBucket(uint32_t index) {
+        std::vector<uint32_t>& bucket = buckets[chunk[index]];
+        uint32_t slot = bucketSlot[index];
+        bucket[slot] = bucket.back();
+        bucketSlot[bucket[slot]] = slot;
+        bucket.pop_back();
+    }
+
+    //++ Moves the dense entry "from" into the free position "to" (swap remove)
+    void moveDense(uint32_t from, uint32_t to) {
+        x[to]    = x[from];
+        y[to]    = y[from];
+        vx[to]   = vx[from];
+        vy[to]   = vy[from];
+        type[to] = type[from];
+        ids[to]  = ids[from];
+        chunk[to]      = chunk[from];
+        bucketSlot[to] = bucketSlot[from];
+
+        buckets[chunk[to]][bucketSlot[to]] = to;
+        slots[ids[to]].dense = to;
+    }
+};
+
+//++ xorshift32, good enough for wandering
+inline uint32_t nextEntityRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+//++ Wander system: new direction every 1 - 3 seconds, one in four turns is a pause
+void updateWander(EntityStore& store, float deltaTime) {
+    for (size_t i = 0; i < store.wanders.size(); ++i) {
+        Wander& wander = store.wanders.data[i];
+        wander.timer -= deltaTime;
+        if (wander.timer > 0.0f) continue;
+
+        uint32_t index = store.indexOf(store.wanders.owners[i]);
+        uint32_t roll  = nextEntityRandom(wander.rng);
+        wander.timer   = 1.0f + float(roll % 2000) / 1000.0f;
+
+        if ((roll >> 12) % 4 == 0) {
+            store.vx[index] = 0.0f;
+            store.vy[index] = 0.0f;
+            continue;
+        }
+
+        float angle = float(roll >> 16) / 65536.0f * 6.2831853f;
+        float speed = entityTypeInfo(store.type[index]).speed;
+        store.vx[index] = std::cos(angle) * speed;
+        store.vy[index] = std::sin(angle) * speed;
+    }
+}
+
+/*
+++ Hunt system
+Followers within HUNT_RADIUS of the player ask the PathService for a path to the player tile every HUNT_REPATH seconds
+(spread by the entity id, so a group of hunters does not request in the same frame) and steer along the returned tiles.
+*/
+static constexpr float HUNT_RADIUS = 12.0f * TILESIZE;
+static constexpr float HUNT_REPATH = 0.75f;
+
+//++ Sound of an entity at a world position (pixels), played by the game (audio.hpp)
+struct EntitySound {
+    ENTITYTYPE type;
+    float x;
+    float y;
+};
+
+void updateHunters(EntityStore& store, PathService& paths, const Player& p, float deltaTime, std::vector<EntitySound>& sounds) {
+    static std::vector<PathResult> results;
+    results.clear();
+    paths.poll(results);
+    for (PathResult& result : results) {
+        Entity owner = {result.owner, result.generation};
+        if (!store.alive(owner)) continue;
+        if (PathFollower* follower = store.followers.get(owner.id)) {
+            //-> A found path of an entity that was not hunting yet: it starts to hunt
+            if (result.found && follower->path.empty()) {
+                uint32_t index = store.indexOf(owner.id);
+                sounds.push_back({store.type[index], store.centerX(index), store.centerY(index)});
+            }
+            follower->path = result.found ? std::move(result.tiles) : std::vector<std::array<int, 2>>{};
+            follower->next = 0;
+        }
+    }
+
+    float playerX = p.x + p.width * 0.5f;
+    float playerY = p.y + p.height * 0.5f;
+
+    for (size_t i = 0; i < store.followers.size(); ++i) {
+        PathFollower& follower = store.followers.data[i];
+        uint32_t id    = store.followers.owners[i];
+        uint32_t index = store.indexOf(id);
+        float cx = store.centerX(index);
+        float cy = store.centerY(index);
+
+        follower.repathTimer -= deltaTime;
+        if (follower.repathTimer <= 0.0f) {
+            follower.repathTimer = HUNT_REPATH + float(id % 8) * (HUNT_REPATH / 8.0f);
+
+            float dx = playerX - cx, dy = playerY - cy;
+            if (dx * dx + dy * dy <= HUNT_RADIUS * HUNT_RADIUS) {
+                PathRequest pathRequest;
+                pathRequest.owner      = id;
+                pathRequest.generation = store.generationOf(id);
+                pathRequest.startX = worldToTile(cx);
+                pathRequest.startY = worldToTile(cy);
+                pathRequest.goalX  = worldToTile(playerX);
+                pathRequest.goalY  = worldToTile(playerY);
+                paths.request(pathRequest);
+            } else if (!follower.path.empty()) {
+                follower.path.clear();
+                store.vx[index] = 0.0f;
+                store.vy[index] = 0.0f;
+            }
+        }
+
+        if (follower.path.empty()) continue;
+
+        //-> Tile center reached (within 4 pixels): next tile, end of the path: stop and let Wander take over again
+        const std::array<int, 2>& tile = follower.path[follower.next];
+        float tx = (tile[0] + 0.5f) * TILESIZE - cx;
+        float ty = (tile[1] + 0.5f) * TILESIZE - cy;
+        float distance = std::sqrt(tx * tx + ty * ty);
+        if (distance < 4.0f) {
+            if (++follower.next >= follower.path.size()) {
+                follower.path.clear();
+                store.vx[index] = 0.0f;
+                store.vy[index] = 0.0f;
+            }
+            continue;
+        }
+
+        float speed = entityTypeInfo(store.type[index]).speed;
+        store.vx[index] = tx / distance * speed;
+        store.vy[index] = ty / distance * speed;
+    }
+}
+
+//++ Movement system: moves every entity with a velocity against the walls, a wall hit stops that axis
+void updateMovement(EntityStore& store, ChunkManager& mgr, float deltaTime) {
+    for (uint32_t index = 0; index < store.size(); ++index) {
+        if (store.vx[index] == 0.0f && store.vy[index] == 0.0f) continue;
+
+        const EntityTypeInfo& info = entityTypeInfo(store.type[index]);
+        CollisionResult result = moveBox(mgr, store.x[index], store.y[index], info.width, info.height, store.vx[index] * deltaTime, store.vy[index] * deltaTime);
+        if (result.normalX != 0) store.vx[index] = 0.0f;
+        if (result.normalY != 0) store.vy[index] = 0.0f;
+        store.moved(index);
+    }
+}
+
+void updateEntities(EntityStore& store, ChunkManager& mgr, PathService& paths, const Player& p, float deltaTime, std::vector<EntitySound>& sounds) {
+    updateWander(store, deltaTime);
+    updateHunters(store, paths, p, deltaTime, sounds);
+    updateMovement(store, mgr, deltaTime);
+}
+
+void renderEntities(RenderQueue& queue, const EntityStore& store, const TextureStore& textures) {
+    //-> Texture lookups once per type, not per entity
+    SDL_Texture* typeTextures[size_t(ENTITYTYPE::Count)] = {};
+    for (size_t t = 0; t < size_t(ENTITYTYPE::Count); ++t) {
+        typeTextures[t] = textures.find(std::string(ENTITYTYPES[t].texture));
+    }
+
+    for (uint32_t index = 0; index < store.size(); ++index) {
+        SDL_Texture* texture = typeTextures[size_t(store.type[index])];
+        if (!texture) continue;
+
+        const EntityTypeInfo& info = entityTypeInfo(store.type[index]);
+        SDL_FRect dst = {store.x[index], store.y[index], info.width, info.height};
+        queue.sprite(RENDERLAYER::ENTITIES, texture, nullptr, dst);
+    }
+}
+
+/*
+++ Spawns the entities of a chunk from the "possibleEntities" of the level
+Every slot picks one name of the list, "" is a slot without entity. The result only depends on seed and chunk.
+Entities are placed on tiles without walls, a slot whose tile is a wall stays empty.
+*/
+static constexpr int ENTITY_SLOTS_PER_CHUNK = 4;
+
+int spawnChunkEntities(EntityStore& store, ChunkManager& mgr, const std::vector<std::string>& possibleEntities, int chunkX, int chunkY, uint32_t seed) {
+    if (possibleEntities.empty()) return 0;
+
+    Chunk* c = mgr.getChunk(chunkX, chunkY);
+    uint32_t rng = (seed ^ (uint32_t(chunkX) * 0x9E3779B1u) ^ (uint32_t(chunkY) * 0x85EBCA77u)) | 1u;
+
+    int spawned = 0;
+    for (int slot = 0; slot < ENTITY_SLOTS_PER_CHUNK; ++slot) {
+        const std::string& name = possibleEntities[nextEntityRandom(rng) % possibleEntities.size()];
+        int tx = int(nextEntityRandom(rng) % CHUNKSIZE);
+        int ty = int(nextEntityRandom(rng) % CHUNKSIZE);
+        uint32_t wanderSeed = nextEntityRandom(rng) | 1u;
+        if (name.empty() || c->tiles[ty][tx].isWall) continue;
+
+        ENTITYTYPE entityType = getEntityType(name);
+        if (entityType == ENTITYTYPE::UNKNOWN) continue;
+
+        Entity entity = store.create(entityType, float((chunkX * CHUNKSIZE + tx) * TILESIZE), float((chunkY * CHUNKSIZE + ty) * TILESIZE));
+        store.wanders.add(entity.id, {0.0f, wanderSeed});
+        if (entityTypeInfo(entityType).hunts) {
+            store.followers.add(entity.id, {});
+        }
+        ++spawned;
+    }
+    return spawned;
+}
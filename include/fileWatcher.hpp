@@ -0,0 +1,158 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <JFLX/logging.hpp>
+
+/*
+++ File Watcher
+A background thread calls the callback of a watched file after it changed (the callback runs on that thread, so it can
+also do the expensive part of a reload: parsing configs, decoding images).
+Linux uses inotify on the directories of the files (editors often replace a file instead of writing it),
+other systems or a failed inotify fall back to comparing the modification time every WATCH_POLLMS.
+Events are collected for WATCH_DEBOUNCEMS, so a file written in several steps is loaded once.
+*/
+static constexpr int WATCH_POLLMS      = 1000;
+static constexpr int WATCH_DEBOUNCEMS  = 100;
+
+class FileWatcher {
+public:
+    ~FileWatcher() {
+        stop();
+    }
+
+    //++ Call before start()
+    void watch(const std::string& filePath, std::function<void()> onChange) {
+        WatchedFile& file = files.emplace_back();
+        file.path     = std::filesystem::absolute(filePath).lexically_normal();
+        file.onChange = std::move(onChange);
+        file.lastWrite = modificationTime(file.path);
+    }
+
+    void start() {
+        if (thread.joinable() || files.empty()) return;
+        stopping = false;
+        thread = std::thread([this]() { run(); });
+    }
+
+    void stop() {
+        if (!thread.joinable()) return;
+        stopping = true;
+        thread.join();
+    }
+
+private:
+    struct WatchedFile {
+        std::filesystem::path path;
+        std::function<void()> onChange;
+        std::filesystem::file_time_type lastWrite;
+    };
+
+    std::vector<WatchedFile> files;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+
+    static std::filesystem::file_time_type modificationTime(const std::filesystem::path& filePath) {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(filePath, error);
+        return error ? std::filesystem::file_time_type::min() : time;
+    }
+
+    void reload(std::vector<bool>& changed) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!changed[i]) continue;
+            changed[i] = false;
+            files[i].lastWrite = modificationTime(files[i].path);
+            JFLX::log("File Watcher: ", "Reloading " + files[i].path.string(), JFLX::LOGTYPE::INFO);
+            files[i].onChange();
+        }
+    }
+
+    void run() {
+#ifdef __linux__
+        if (runInotify()) return;
+        JFLX::log("File Watcher: ", "inotify not available, checking watched files every " + std::to_string(WATCH_POLLMS) + " ms", JFLX::LOGTYPE::WARNING);
+#endif
+        runPolling();
+    }
+
+    void runPolling() {
+        std::vector<bool> changed(files.size(), false);
+        while (!stopping) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(WATCH_POLLMS));
+            for (size_t i = 0; i < files.size(); ++i) {
+                changed[i] = modificationTime(files[i].path) != files[i].lastWrite;
+            }
+            reload(changed);
+        }
+    }
+
+#ifdef __linux__
+    //++ false when inotify could not be set up
+    bool runInotify() {
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) return false;
+
+        std::unordered_map<int, std::filesystem::path> directories;
+        for (const WatchedFile& file : files) {
+            std::filesystem::path directory = file.path.parent_path();
+            int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (wd < 0) {
+                close(fd);
+                return false;
+            }
+            directories[wd] = directory;
+        }
+
+        std::vector<bool> changed(files.size(), false);
+        bool anyChanged = false;
+        alignas(inotify_event) char buffer[4096];
+        while (!stopping) {
+            //-> Short timeout: stop() is noticed quickly, changed files are loaded once the events stopped
+            pollfd request = {fd, POLLIN, 0};
+            int ready = poll(&request, 1, anyChanged ? WATCH_DEBOUNCEMS : 250);
+            if (ready == 0 && anyChanged) {
+                reload(changed);
+                anyChanged = false;
+                continue;
+            }
+            if (ready <= 0) continue;
+
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* at = buffer; at < buffer + length; ) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(at);
+                    at += sizeof(inotify_event) + event->len;
+                    if (event->len == 0) continue;
+
+                    auto directory = directories.find(event->wd);
+                    if (directory == directories.end()) continue;
+                    std::filesystem::path eventPath = directory->second / event->name;
+                    for (size_t i = 0; i < files.size(); ++i) {
+                        if (files[i].path == eventPath) {
+                            changed[i] = true;
+                            anyChanged = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        close(fd);
+        return true;
+    }
+#endif
+};
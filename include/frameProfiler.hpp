@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include <JFLX/logging.hpp>
+
+/*
+++ Frame Profiler
+Keeps the time of every frame (and of its update / render part) of a run, reports the distribution as percentiles
+so two builds can be compared on the same replayed session (inputRecording.hpp). Only samples are stored during
+the run, sorting happens in the report.
+*/
+struct FrameSample {
+    float frameMs  = 0.0f;
+    float updateMs = 0.0f;
+    float renderMs = 0.0f;
+};
+
+struct FrameStats {
+    size_t frames = 0;
+    float mean = 0.0f;
+    float p50  = 0.0f;
+    float p95  = 0.0f;
+    float p99  = 0.0f;
+    float max  = 0.0f;
+};
+
+class FrameProfiler {
+public:
+    void reserve(size_t frames) {
+        samples.reserve(frames);
+    }
+
+    void add(const FrameSample& sample) {
+        samples.push_back(sample);
+    }
+
+    size_t size() const {
+        return samples.size();
+    }
+
+    void clear() {
+        samples.clear();
+    }
+
+    //++ Distribution of one part of the samples, e.g. stats(&FrameSample::frameMs)
+    FrameStats stats(float FrameSample::* field) const {
+        FrameStats result;
+        if (samples.empty()) return result;
+
+        std::vector<float> values;
+        values.reserve(samples.size());
+        double sum = 0.0;
+        for (const FrameSample& sample : samples) {
+            values.push_back(sample.*field);
+            sum += sample.*field;
+        }
+        std::sort(values.begin(), values.end());
+
+        //-> Nearest rank
+        auto percentile = [&](float p) {
+            size_t rank = size_t(p * float(values.size() - 1) + 0.5f);
+            return values[std::min(rank, values.size() - 1)];
+        };
+        result.frames = values.size();
+        result.mean   = float(sum / double(values.size()));
+        result.p50    = percentile(0.50f);
+        result.p95    = percentile(0.95f);
+        result.p99    = percentile(0.99f);
+        result.max    = values.back();
+        return result;
+    }
+
+    //++ Logs the percentiles of frame, update and render time
+    void report(const std::string& name) const {
+        static constexpr struct {
+            const char* name;
+            float FrameSample::* field;
+        } PARTS[] = {{"frame", &FrameSample::frameMs}, {"update", &FrameSample::updateMs}, {"render", &FrameSample::renderMs}};
+
+        JFLX::log("Profiler: ", name + ", " + std::to_string(samples.size()) + " frames (ms)", JFLX::LOGTYPE::INFO);
+        for (const auto& part : PARTS) {
+            FrameStats s = stats(part.field);
+            char line[160];
+            std::snprintf(line, sizeof(line), "%-6s mean %7.3f  p50 %7.3f  p95 %7.3f  p99 %7.3f  max %7.3f", part.name, s.mean, s.p50, s.p95, s.p99, s.max);
+            JFLX::log("Profiler: ", line, JFLX::LOGTYPE::INFO);
+        }
+    }
+
+    //++ One line per frame, for plotting / comparing runs outside of the game
+    bool writeCsv(const std::string& filePath) const {
+        std::ofstream file(filePath, std::ios::trunc);
+        if (!file.is_open()) {
+            JFLX::log("Profiler: ", "Failed to open " + filePath, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+        file << "frame,frameMs,updateMs,renderMs\n";
+        for (size_t i = 0; i < samples.size(); ++i) {
+            file << i << ',' << samples[i].frameMs << ',' << samples[i].updateMs << ',' << samples[i].renderMs << '\n';
+        }
+        JFLX::log("Profiler: ", "Wrote " + std::to_string(samples.size()) + " frames to " + filePath, JFLX::LOGTYPE::SUCCESS);
+        return true;
+    }
+
+private:
+    std::vector<FrameSample> samples;
+};
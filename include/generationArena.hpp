@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <memory_resource>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef NOGDI
+        #define NOGDI   //-> wingdi.h defines ERROR, which breaks JFLX::LOGTYPE::ERROR
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+/*
+++ Arena for the World Generator
+All scratch memory of a world (noise / tile planes, row and column tables, work lists) is bump allocated from page backed blocks.
+Nothing is freed on its own: rewind(marker) drops everything allocated after the marker, reset() drops everything at the end of a world.
+The blocks are kept for the next world of a batch, so a batch only maps pages for the biggest world.
+
+- Blocks are requested as large pages where the OS allows it (Windows: MEM_LARGE_PAGES, Linux: MAP_HUGETLB / transparent huge pages)
+- peak() is the highest number of bytes in use since the last reset, used for the memory report of a world
+- The arena is also a std::pmr::memory_resource, so std::pmr containers can allocate from it (deallocation is a no-op)
+
+!! Not thread safe: only allocate from the generating thread, never inside a parallelFor job !!
+*/
+struct ArenaMarker {
+    size_t block  = 0;
+    size_t offset = 0;
+};
+
+class GenerationArena : public std::pmr::memory_resource {
+public:
+    explicit GenerationArena(size_t blockSize_ = size_t(64) << 20) : blockSize(blockSize_) {}
+
+    ~GenerationArena() override {
+        trim();
+    }
+
+    GenerationArena(const GenerationArena&) = delete;
+    GenerationArena& operator=(const GenerationArena&) = delete;
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    ArenaMarker mark() const {
+        if (blocks.empty()) return {};
+        return {current, blocks[current].used};
+    }
+
+    //++ Drops every allocation made after the marker
+    void rewind(const ArenaMarker& marker) {
+        if (blocks.empty()) return;
+        for (size_t b = marker.block + 1; b < blocks.size(); ++b) {
+            blocks[b].used = 0;
+        }
+        current = marker.block;
+        blocks[current].used = marker.offset;
+        inUse = usedBytes();
+    }
+
+    //++ Drops every allocation, the pages are kept for the next world
+    void reset() {
+        rewind({});
+        highWater = 0;
+    }
+
+    //++ Returns all pages to the OS
+    void trim() {
+        for (Block& block : blocks) {
+            freePages(block);
+        }
+        blocks.clear();
+        current   = 0;
+        inUse     = 0;
+        highWater = 0;
+    }
+
+    size_t used() const { return inUse; }
+    size_t peak() const { return highWater; }
+
+    size_t reserved() const {
+        size_t total = 0;
+        for (const Block& block : blocks) total += block.size;
+        return total;
+    }
+
+    bool usesLargePages() const {
+        return std::any_of(blocks.begin(), blocks.end(), [](const Block& block) { return block.largePages; });
+    }
+
+private:
+    struct Block {
+        uint8_t* data   = nullptr;
+        size_t size     = 0;
+        size_t used     = 0;
+        bool largePages = false;
+    };
+
+    static constexpr size_t LARGEPAGE = size_t(2) << 20;
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    size_t current   = 0;
+    size_t inUse     = 0;
+    size_t highWater = 0;
+
+    size_t usedBytes() const {
+        size_t total = 0;
+        for (const Block& block : blocks) total += block.used;
+        return total;
+    }
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        bytes = std::max<size_t>(bytes, 1);
+
+        //++ Current block first, then the (empty) blocks after it, then a new block
+        for (size_t b = blocks.empty() ? 0 : current; b < blocks.size(); ++b) {
+            Block& block = blocks[b];
+            size_t offset = alignUp(uintptr_t(block.data + block.used), alignment) - uintptr_t(block.data);
+            if (offset + bytes <= block.size) {
+                current = b;
+                inUse += offset + bytes - block.used;
+                block.used = offset + bytes;
+                highWater = std::max(highWater, inUse);
+                return block.data + offset;
+            }
+        }
+
+        Block block = allocatePages(alignUp(std::max(blockSize, bytes + alignment), LARGEPAGE));
+        if (block.data == nullptr) {
+            throw std::bad_alloc();
+        }
+        blocks.push_back(block);
+        current = blocks.size() - 1;
+
+        Block& added = blocks.back();
+        size_t offset = alignUp(uintptr_t(added.data), alignment) - uintptr_t(added.data);
+        added.used = offset + bytes;
+        inUse += added.used;
+        highWater = std::max(highWater, inUse);
+        return added.data + offset;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    static Block allocatePages(size_t size) {
+        Block block;
+        block.size = size;
+
+#if defined(_WIN32)
+        //++ Large pages need the "Lock pages in memory" privilege, fall back to normal pages without it
+        SIZE_T largePage = GetLargePageMinimum();
+        if (largePage > 0 && size % largePage == 0) {
+            block.data = static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+            block.largePages = block.data != nullptr;
+        }
+        if (block.data == nullptr) {
+            block.data = static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+        }
+#elif defined(__linux__)
+        void* pages = MAP_FAILED;
+    #ifdef MAP_HUGETLB
+        pages = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        block.largePages = pages != MAP_FAILED;
+    #endif
+        if (pages == MAP_FAILED) {
+            pages = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    #ifdef MADV_HUGEPAGE
+            if (pages != MAP_FAILED) block.largePages = madvise(pages, size, MADV_HUGEPAGE) == 0;
+    #endif
+        }
+        block.data = pages == MAP_FAILED ? nullptr : static_cast<uint8_t*>(pages);
+#else
+        block.data = static_cast<uint8_t*>(std::aligned_alloc(LARGEPAGE, size));
+#endif
+        return block;
+    }
+
+    static void freePages(Block& block) {
+        if (block.data == nullptr) return;
+#if defined(_WIN32)
+        VirtualFree(block.data, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        munmap(block.data, block.size);
+#else
+        std::free(block.data);
+#endif
+        block.data = nullptr;
+    }
+};
+
+//++ The arena shared by all worlds of the process, created on first use
+inline GenerationArena& generationArena() {
+    static GenerationArena arena;
+    return arena;
+}
+
+template <typename T>
+using ArenaVector = std::pmr::vector<T>;
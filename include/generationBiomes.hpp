@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+
+#include "tiles.hpp"
+#include "generationPlanes.hpp"
+#include "generationWorkers.hpp"
+
+/*
+++ Biome Painter
+The block / wall replace maps of a biome are compiled into dense ID indexed tables and its circles are rasterised as row spans.
+All biomes are painted in one pass over the rows, rows are split between the generation workers.
+Per row the biomes (and their circles) are applied in the order they were added, so the result equals painting them one after another.
+*/
+struct BiomeCircle {
+    int centerX = 0;
+    int centerY = 0;
+    int radius  = 0;
+};
+
+struct Biome {
+    //++ matched[ID] != 0 when the ID has a replace rule
+    std::array<uint8_t, 256> blockMatched{};
+    std::array<uint8_t, 256> blockToBlock{};
+    std::array<uint8_t, 256> blockToWall{};
+
+    std::array<uint8_t, 256> wallMatched{};
+    std::array<uint8_t, 256> wallToBlock{};
+    std::array<uint8_t, 256> wallToWall{};
+
+    //++ Painting twice equals painting once, overlapping circles can then be merged into one span
+    bool idempotent = true;
+
+    std::vector<BiomeCircle> circles;
+
+    Biome(const std::unordered_map<TILES::BLOCKS::ID, TILES::TileArray>& replaceMapBlock, const std::unordered_map<TILES::WALLS::ID, TILES::TileArray>& replaceMapWall) {
+        for (const auto& [id, to] : replaceMapBlock) {
+            blockMatched[static_cast<uint8_t>(id)] = 1;
+            blockToBlock[static_cast<uint8_t>(id)] = static_cast<uint8_t>(to.block);
+            blockToWall[static_cast<uint8_t>(id)]  = static_cast<uint8_t>(to.wall);
+        }
+        for (const auto& [id, to] : replaceMapWall) {
+            wallMatched[static_cast<uint8_t>(id)] = 1;
+            wallToBlock[static_cast<uint8_t>(id)] = static_cast<uint8_t>(to.block);
+            wallToWall[static_cast<uint8_t>(id)]  = static_cast<uint8_t>(to.wall);
+        }
+
+        for (int b = 0; b < 256 && idempotent; ++b) {
+            for (int w = 0; w < 256; ++w) {
+                uint8_t b1 = uint8_t(b), w1 = uint8_t(w);
+                paint(b1, w1);
+                uint8_t b2 = b1, w2 = w1;
+                paint(b2, w2);
+                if (b1 != b2 || w1 != w2) {
+                    idempotent = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    void addCircle(int centerX, int centerY, int radius) {
+        circles.push_back({centerX, centerY, radius});
+    }
+
+    //++ Same rules as the former fillCircularAreaFillCall
+    void paint(uint8_t& block, uint8_t& wall) const {
+        if (block == static_cast<uint8_t>(TILES::BLOCKS::ID::AIR) && wall == static_cast<uint8_t>(TILES::WALLS::ID::AIR)) {
+            return;
+        }
+
+        uint8_t newBlock, newWall;
+        if (blockMatched[block]) {
+            newBlock = blockToBlock[block];
+            newWall  = blockToWall[block];
+        } else if (wallMatched[wall]) {
+            newBlock = wallToBlock[wall];
+            newWall  = wallToWall[wall];
+        } else {
+            return;
+        }
+
+        if (newBlock != static_cast<uint8_t>(TILES::BLOCKS::ID::NOCHANGE)) block = newBlock;
+        if (newWall  != static_cast<uint8_t>(TILES::WALLS::ID::NOCHANGE))  wall  = newWall;
+    }
+
+    void paintSpan(uint8_t* blocks, uint8_t* walls, int xBegin, int xEnd) const {
+        for (int x = xBegin; x <= xEnd; ++x) {
+            paint(blocks[x], walls[x]);
+        }
+    }
+};
+
+//++ Span of a circle on world row y (inclusive), false when the row misses the circle
+inline bool circleSpan(const BiomeCircle& circle, int y, int sizeX, int& xBegin, int& xEnd) {
+    int dy = y - circle.centerY;
+    if (dy < -circle.radius || dy > circle.radius) return false;
+
+    int64_t rest = int64_t(circle.radius) * circle.radius - int64_t(dy) * dy;
+    int halfWidth = int(std::sqrt(double(rest)));
+    while (int64_t(halfWidth + 1) * (halfWidth + 1) <= rest) ++halfWidth;
+    while (int64_t(halfWidth) * halfWidth > rest) --halfWidth;
+
+    xBegin = std::max(0, circle.centerX - halfWidth);
+    xEnd   = std::min(sizeX - 1, circle.centerX + halfWidth);
+    return xBegin <= xEnd;
+}
+
+inline void paintBiomeRow(TilePlanes& tileMap, const Biome& biome, int y) {
+    uint8_t* blocks = tileMap.blocks.get() + tileMap.indexOf(0, y);
+    uint8_t* walls  = tileMap.walls.get() + tileMap.indexOf(0, y);
+
+    //++ Idempotent biomes: merge overlapping spans so every tile is painted once
+    int spanBegin = 0, spanEnd = -1;
+    for (const BiomeCircle& circle : biome.circles) {
+        int xBegin, xEnd;
+        if (!circleSpan(circle, y, tileMap.sizeX, xBegin, xEnd)) continue;
+
+        if (!biome.idempotent) {
+            biome.paintSpan(blocks, walls, xBegin, xEnd);
+        } else if (spanEnd >= spanBegin && xBegin <= spanEnd + 1 && xEnd >= spanBegin - 1) {
+            spanBegin = std::min(spanBegin, xBegin);
+            spanEnd   = std::max(spanEnd, xEnd);
+        } else {
+            if (spanEnd >= spanBegin) biome.paintSpan(blocks, walls, spanBegin, spanEnd);
+            spanBegin = xBegin;
+            spanEnd   = xEnd;
+        }
+    }
+    if (biome.idempotent && spanEnd >= spanBegin) {
+        biome.paintSpan(blocks, walls, spanBegin, spanEnd);
+    }
+}
+
+//++ Paints all biomes on the world rows [rowBegin, rowEnd) held by tileMap
+inline void paintBiomes(TilePlanes& tileMap, const std::vector<Biome>& biomes, int rowBegin, int rowEnd) {
+    generationWorkers().parallelFor(rowBegin, rowEnd, 16, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            for (const Biome& biome : biomes) {
+                paintBiomeRow(tileMap, biome, y);
+            }
+        }
+    });
+}
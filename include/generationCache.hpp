@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+
+#include <JFLX/logging.hpp>
+
+/*
+++ Stage Cache for Incremental World Generation
+The output of every stage is stored per region (band of rows) in "worldData/cache/<stage>_<region>.bin",
+together with a key that hashes the seed, the world size, the parameters the stage reads and the key of the stage before it.
+On the next run a stage region whose key still matches is loaded instead of generated, see runGenerationStages in generation.cpp.
+
+File: magic, version, key, sizeX, rowBegin, rowEnd, plane count, seed count | planes (rows of the region) | seeds (x, y)
+Only the newest output of a stage region is kept, a changed key overwrites the file.
+A file is written next to its place and renamed over it when complete, a file of another size than its header
+describes (cut off, e.g. a crash while it was copied) never matches.
+
+!! Bump GENERATION_CACHE_VERSION when the code of a stage changes in a way its parameter hash does not see !!
+*/
+static constexpr uint32_t GENERATION_CACHE_VERSION = 1;
+static constexpr uint32_t GENERATION_CACHE_MAGIC   = 0x43475242; // "BRGC"
+
+//++ FNV-1a, only used for cache keys
+struct CacheHash {
+    uint64_t value = 1469598103934665603ull;
+
+    CacheHash& bytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            value = (value ^ p[i]) * 1099511628211ull;
+        }
+        return *this;
+    }
+
+    //++ Only for types without padding (ints, enums, arrays of bytes)
+    template <typename T>
+    CacheHash& add(const T& data) {
+        static_assert(std::is_trivially_copyable_v<T>, "CacheHash::add needs a trivially copyable type");
+        return bytes(&data, sizeof(T));
+    }
+};
+
+class StageCache {
+public:
+    StageCache(const std::string& directory_, int sizeX_, int sizeY_, int regionRows_ = 256) : directory(directory_), sizeX(sizeX_), sizeY(sizeY_), regionRows(regionRows_) {
+        std::filesystem::create_directories(directory);
+    }
+
+    int regionCount() const {
+        return (sizeY + regionRows - 1) / regionRows;
+    }
+
+    int regionBegin(int region) const {
+        return region * regionRows;
+    }
+
+    int regionEnd(int region) const {
+        return std::min(sizeY, (region + 1) * regionRows);
+    }
+
+    //++ Only reads the header (and the size of the file)
+    bool has(const std::string& stage, int region, uint64_t key) const {
+        std::ifstream file(filePath(stage, region), std::ios::binary);
+        Header header;
+        return file.read(reinterpret_cast<char*>(&header), sizeof(header)) && matches(header, region, key) && complete(header, filePath(stage, region));
+    }
+
+    /*
+    ++ planes are whole world planes (row 0 = world row 0), seeds of the region are appended to "seeds"
+    The region is read into a scratch buffer first, planes and seeds are only changed when the whole file was read.
+    */
+    bool load(const std::string& stage, int region, uint64_t key, std::initializer_list<uint8_t*> planes, std::vector<std::array<int, 2>>* seeds = nullptr) const {
+        std::ifstream file(filePath(stage, region), std::ios::binary);
+        Header header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !matches(header, region, key) || header.planeCount != planes.size() || !complete(header, filePath(stage, region))) {
+            return false;
+        }
+
+        size_t offset = size_t(regionBegin(region)) * sizeX;
+        size_t count  = size_t(regionEnd(region) - regionBegin(region)) * sizeX;
+        std::vector<uint8_t> regionPlanes(planes.size() * count);
+        if (!file.read(reinterpret_cast<char*>(regionPlanes.data()), std::streamsize(regionPlanes.size()))) {
+            return false;
+        }
+
+        std::vector<std::array<int, 2>> regionSeeds(header.seedCount);
+        if (header.seedCount > 0 && !file.read(reinterpret_cast<char*>(regionSeeds.data()), std::streamsize(header.seedCount * sizeof(std::array<int, 2>)))) {
+            return false;
+        }
+
+        const uint8_t* source = regionPlanes.data();
+        for (uint8_t* plane : planes) {
+            std::memcpy(plane + offset, source, count);
+            source += count;
+        }
+        if (seeds != nullptr) {
+            seeds->insert(seeds->end(), regionSeeds.begin(), regionSeeds.end());
+        }
+        return true;
+    }
+
+    //++ Stores the rows of the region and every seed that lies in them
+    bool store(const std::string& stage, int region, uint64_t key, std::initializer_list<const uint8_t*> planes, const std::vector<std::array<int, 2>>* seeds = nullptr) const {
+        std::vector<std::array<int, 2>> regionSeeds;
+        if (seeds != nullptr) {
+            for (const std::array<int, 2>& seed : *seeds) {
+                if (seed[1] >= regionBegin(region) && seed[1] < regionEnd(region)) regionSeeds.push_back(seed);
+            }
+        }
+
+        Header header;
+        header.key        = key;
+        header.sizeX      = sizeX;
+        header.rowBegin   = regionBegin(region);
+        header.rowEnd     = regionEnd(region);
+        header.planeCount = uint32_t(planes.size());
+        header.seedCount  = uint32_t(regionSeeds.size());
+
+        //-> Written to a temporary file and renamed over the old one, a cut off write never replaces a complete file
+        std::string path      = filePath(stage, region);
+        std::string writePath = path + ".tmp";
+        std::ofstream file(writePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        size_t offset = size_t(header.rowBegin) * sizeX;
+        size_t count  = size_t(header.rowEnd - header.rowBegin) * sizeX;
+        for (const uint8_t* plane : planes) {
+            file.write(reinterpret_cast<const char*>(plane + offset), std::streamsize(count));
+        }
+        file.write(reinterpret_cast<const char*>(regionSeeds.data()), std::streamsize(regionSeeds.size() * sizeof(std::array<int, 2>)));
+        file.close();
+
+        std::error_code error;
+        if (!file) {
+            JFLX::log("World Generation: ", "Failed to write stage cache " + writePath, JFLX::LOGTYPE::WARNING);
+            std::filesystem::remove(writePath, error);
+            return false;
+        }
+        std::filesystem::rename(writePath, path, error);
+        if (error) {
+            JFLX::log("World Generation: ", "Failed to replace stage cache " + path + ": " + error.message(), JFLX::LOGTYPE::WARNING);
+            std::filesystem::remove(writePath, error);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct Header {
+        uint32_t magic      = GENERATION_CACHE_MAGIC;
+        uint32_t version    = GENERATION_CACHE_VERSION;
+        uint64_t key        = 0;
+        int32_t sizeX       = 0;
+        int32_t rowBegin    = 0;
+        int32_t rowEnd      = 0;
+        uint32_t planeCount = 0;
+        uint32_t seedCount  = 0;
+        uint32_t reserved   = 0;
+    };
+
+    std::string directory;
+    int sizeX;
+    int sizeY;
+    int regionRows;
+
+    std::string filePath(const std::string& stage, int region) const {
+        return directory + "/" + stage + "_" + std::to_string(region) + ".bin";
+    }
+
+    bool matches(const Header& header, int region, uint64_t key) const {
+        return header.magic == GENERATION_CACHE_MAGIC && header.version == GENERATION_CACHE_VERSION && header.key == key
+            && header.sizeX == sizeX && header.rowBegin == regionBegin(region) && header.rowEnd == regionEnd(region);
+    }
+
+    //-> The file holds exactly the planes and seeds its (matching) header describes
+    bool complete(const Header& header, const std::string& path) const {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        size_t count   = size_t(header.rowEnd - header.rowBegin) * sizeX;
+        return !error && size == sizeof(Header) + header.planeCount * count + header.seedCount * sizeof(std::array<int, 2>);
+    }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+/*
+++ Coordinate Addressable Gradient Noise
+JFLX::perlinNoise can only fill a complete map at once. The streamed generation only holds a few rows at a time,
+so it samples this noise per position instead. Values are returned in the same 0..255 range as the packed noise planes.
+*/
+inline uint32_t hashCoords(int seed, int x, int y) {
+    uint32_t h = uint32_t(seed) * 0x9E3779B1u;
+    h ^= uint32_t(x) * 0x85EBCA77u;
+    h  = (h << 13) | (h >> 19);
+    h ^= uint32_t(y) * 0xC2B2AE3Du;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+inline float gradientDot(uint32_t hash, float dx, float dy) {
+    switch (hash & 7) {
+        case 0:  return  dx + dy;
+        case 1:  return  dx - dy;
+        case 2:  return -dx + dy;
+        case 3:  return -dx - dy;
+        case 4:  return  dx;
+        case 5:  return -dx;
+        case 6:  return  dy;
+        default: return -dy;
+    }
+}
+
+inline float fadeCurve(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+//++ Classic 2D perlin noise, roughly -1..1
+inline float gradientNoise(int seed, float x, float y) {
+    int x0 = int(std::floor(x));
+    int y0 = int(std::floor(y));
+    float fx = x - float(x0);
+    float fy = y - float(y0);
+
+    float n00 = gradientDot(hashCoords(seed, x0,     y0),     fx,        fy);
+    float n10 = gradientDot(hashCoords(seed, x0 + 1, y0),     fx - 1.0f, fy);
+    float n01 = gradientDot(hashCoords(seed, x0,     y0 + 1), fx,        fy - 1.0f);
+    float n11 = gradientDot(hashCoords(seed, x0 + 1, y0 + 1), fx - 1.0f, fy - 1.0f);
+
+    float u = fadeCurve(fx);
+    float v = fadeCurve(fy);
+
+    float nx0 = n00 + u * (n10 - n00);
+    float nx1 = n01 + u * (n11 - n01);
+    return nx0 + v * (nx1 - nx0);
+}
+
+//++ Two octaves, mapped to 0..255
+inline uint8_t sampleNoise(int seed, int smoothness, int x, int y) {
+    float scale = 1.0f / float(std::max(1, smoothness));
+    float v = gradientNoise(seed, x * scale, y * scale) + 0.5f * gradientNoise(seed ^ 0x5bd1e995, x * scale * 2.0f, y * scale * 2.0f);
+    return static_cast<uint8_t>(std::clamp(int(128.0f + v * 120.0f), 0, 255));
+}
+
+//++ Fills rows [originY, originY + rows) of the world into a plane holding exactly these rows
+inline void fillNoiseRows(uint8_t* plane, int sizeX, int originY, int rows, int seed, int smoothness) {
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < sizeX; ++x) {
+            plane[size_t(y) * sizeX + x] = sampleNoise(seed, smoothness, x, originY + y);
+        }
+    }
+}
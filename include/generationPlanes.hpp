@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+
+#include "tiles.hpp"
+#include "generationArena.hpp"
+
+/*
+++ Packed Planes for the World Generator
+Block and wall IDs are stored in two separate uint8_t planes (Structure of Arrays) instead of one Tile per position.
+Noise fields only ever hold values from 0..255, so they are stored as uint8_t planes as well.
+A plane can also hold only a window of rows (originY = world row of the first held row), which is used by the streamed generation.
+Planes are either owned (heap) or live in a GenerationArena, arena planes are released with the arena and not by the Plane.
+
+!! Every TILES::BLOCKS::ID and TILES::WALLS::ID used by the generator has to fit into 8 bits !!
+*/
+struct PlaneDeleter {
+    bool owned = true;
+
+    void operator()(uint8_t* plane) const {
+        if (owned) delete[] plane;
+    }
+};
+
+using Plane = std::unique_ptr<uint8_t[], PlaneDeleter>;
+
+inline Plane makePlane(int sizeX, int sizeY) {
+    return Plane(new uint8_t[size_t(sizeX) * size_t(sizeY)]);
+}
+
+inline Plane makePlane(GenerationArena& arena, int sizeX, int sizeY) {
+    return Plane(arena.allocateArray<uint8_t>(size_t(sizeX) * size_t(sizeY)), PlaneDeleter{false});
+}
+
+//++ Clamps a full int noise map (0..255) into an 8 bit plane
+inline void packNoise(const int* noiseMap, uint8_t* plane, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        plane[i] = static_cast<uint8_t>(std::clamp(noiseMap[i], 0, 255));
+    }
+}
+
+struct TilePlanes {
+    int sizeX   = 0;
+    int sizeY   = 0; // rows held
+    int originY = 0; // world row of the first held row
+
+    Plane blocks;
+    Plane walls;
+
+    TilePlanes(int sizeX_, int sizeY_, int originY_ = 0) : sizeX(sizeX_), sizeY(sizeY_), originY(originY_), blocks(makePlane(sizeX_, sizeY_)), walls(makePlane(sizeX_, sizeY_)) {
+        clear();
+    }
+
+    TilePlanes(GenerationArena& arena, int sizeX_, int sizeY_, int originY_ = 0) : sizeX(sizeX_), sizeY(sizeY_), originY(originY_), blocks(makePlane(arena, sizeX_, sizeY_)), walls(makePlane(arena, sizeX_, sizeY_)) {
+        clear();
+    }
+
+    size_t count() const {
+        return size_t(sizeX) * size_t(sizeY);
+    }
+
+    void clear() {
+        std::fill_n(blocks.get(), count(), static_cast<uint8_t>(TILES::BLOCKS::ID::AIR));
+        std::fill_n(walls.get(),  count(), static_cast<uint8_t>(TILES::WALLS::ID::AIR));
+    }
+
+    //++ Coordinates are world coordinates, the index is local to the held rows
+    bool holds(int x, int y) const {
+        return x >= 0 && x < sizeX && y >= originY && y < originY + sizeY;
+    }
+
+    size_t indexOf(int x, int y) const {
+        return size_t(y - originY) * size_t(sizeX) + size_t(x);
+    }
+
+    TILES::BLOCKS::ID block(size_t index) const {
+        return static_cast<TILES::BLOCKS::ID>(blocks[index]);
+    }
+
+    TILES::WALLS::ID wall(size_t index) const {
+        return static_cast<TILES::WALLS::ID>(walls[index]);
+    }
+
+    //++ Same semantics as setTileIDS: NOCHANGE keeps the current ID
+    void set(size_t index, TILES::BLOCKS::ID blockID, TILES::WALLS::ID wallID = TILES::WALLS::ID::NOCHANGE) {
+        if (blockID != TILES::BLOCKS::ID::NOCHANGE) blocks[index] = static_cast<uint8_t>(blockID);
+        if (wallID  != TILES::WALLS::ID::NOCHANGE)  walls[index]  = static_cast<uint8_t>(wallID);
+    }
+};
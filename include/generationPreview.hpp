@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <algorithm>
+#include <array>
+
+#include <JFLX/logging.hpp>
+#include <STB/stb_image_write.h>
+
+#include "tiles.hpp"
+#include "colorStruct.hpp"
+#include "generationPlanes.hpp"
+#include "generationWorkers.hpp"
+
+/*
+++ Preview Pipeline
+Previews are rendered in parallel (rows split between the generation workers) into reused RGB buffers
+and handed to the PreviewEncoder, which writes the PNGs on its own threads while the generation continues.
+
+- downscale: every n-th tile in both directions is used (nearest sample), 1 = full resolution
+- tileSize:  previews wider or higher than tileSize pixels are split into tiles "<name>Preview_<x>_<y>.png", 0 = one image
+Every PNG (or PNG tile) is compressed on its own encoder thread, so big previews are compressed by several threads at once.
+*/
+struct PreviewSettings {
+    int downscale = 1;
+    int tileSize  = 0;
+};
+
+class PreviewEncoder {
+public:
+    explicit PreviewEncoder(unsigned threadCount = std::thread::hardware_concurrency()) {
+        threadCount = std::max(1u, threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            threads.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~PreviewEncoder() {
+        finish();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeWorkers.notify_all();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    PreviewEncoder(const PreviewEncoder&) = delete;
+    PreviewEncoder& operator=(const PreviewEncoder&) = delete;
+
+    //++ Returns a buffer of at least "bytes" bytes, buffers of finished previews are reused
+    std::vector<uint8_t> acquireBuffer(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<uint8_t> buffer;
+        auto it = std::find_if(freeBuffers.begin(), freeBuffers.end(), [&](const std::vector<uint8_t>& b) { return b.capacity() >= bytes; });
+        if (it != freeBuffers.end()) {
+            buffer = std::move(*it);
+            freeBuffers.erase(it);
+        } else if (!freeBuffers.empty()) {
+            buffer = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+        buffer.resize(bytes);
+        return buffer;
+    }
+
+    //++ Queues the RGB image for writing, pngPath is the path without ".png"
+    void submit(const std::string& pngPath, std::vector<uint8_t>&& rgb, int width, int height, int tileSize) {
+        auto image = std::make_shared<Image>();
+        image->rgb    = std::move(rgb);
+        image->width  = width;
+        image->height = height;
+
+        int tile = tileSize > 0 ? tileSize : std::max(width, height);
+        int tilesX = (width + tile - 1) / tile;
+        int tilesY = (height + tile - 1) / tile;
+        bool tiled = tilesX * tilesY > 1;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        image->pendingTiles = tilesX * tilesY;
+        for (int ty = 0; ty < tilesY; ++ty) {
+            for (int tx = 0; tx < tilesX; ++tx) {
+                Job job;
+                job.image  = image;
+                job.path   = tiled ? pngPath + "_" + std::to_string(tx) + "_" + std::to_string(ty) + ".png" : pngPath + ".png";
+                job.x      = tx * tile;
+                job.y      = ty * tile;
+                job.width  = std::min(tile, width - job.x);
+                job.height = std::min(tile, height - job.y);
+                jobs.push_back(job);
+                ++pendingJobs;
+            }
+        }
+        wakeWorkers.notify_all();
+    }
+
+    //++ Blocks until every submitted preview is written
+    void finish() {
+        std::unique_lock<std::mutex> lock(mutex);
+        allDone.wait(lock, [this]() { return pendingJobs == 0; });
+    }
+
+private:
+    struct Image {
+        std::vector<uint8_t> rgb;
+        int width  = 0;
+        int height = 0;
+        int pendingTiles = 0;
+    };
+
+    struct Job {
+        std::shared_ptr<Image> image;
+        std::string path;
+        int x = 0, y = 0, width = 0, height = 0;
+    };
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable allDone;
+    std::deque<Job> jobs;
+    std::vector<std::vector<uint8_t>> freeBuffers;
+    int pendingJobs = 0;
+    bool stopping = false;
+
+    void workerLoop() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeWorkers.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            const uint8_t* first = job.image->rgb.data() + (size_t(job.y) * job.image->width + job.x) * 3;
+            if (!stbi_write_png(job.path.c_str(), job.width, job.height, 3, first, job.image->width * 3)) {
+                JFLX::log("World Generation: ", "Failed to save PNG! " + job.path, JFLX::LOGTYPE::ERROR);
+            } else {
+                JFLX::log("World Generation: ", "Saved preview image " + job.path, JFLX::LOGTYPE::SUCCESS);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--job.image->pendingTiles == 0) {
+                freeBuffers.push_back(std::move(job.image->rgb));
+            }
+            if (--pendingJobs == 0) {
+                allDone.notify_all();
+            }
+        }
+    }
+};
+
+//++ The encoder shared by all worlds of the process, created on first use
+inline PreviewEncoder& previewEncoder() {
+    static PreviewEncoder encoder;
+    return encoder;
+}
+
+inline int previewSize(int size, int downscale) {
+    return (size + downscale - 1) / downscale;
+}
+
+inline void renderNoisePreview(const uint8_t* noisePlane, int sizeX, int sizeY, int downscale, uint8_t* rgb) {
+    int width  = previewSize(sizeX, downscale);
+    int height = previewSize(sizeY, downscale);
+
+    generationWorkers().parallelFor(0, height, 16, [&](int begin, int end) {
+        for (int py = begin; py < end; ++py) {
+            const uint8_t* row = noisePlane + size_t(py) * downscale * sizeX;
+            uint8_t* out = rgb + size_t(py) * width * 3;
+            for (int px = 0; px < width; ++px) {
+                uint8_t g = row[size_t(px) * downscale];
+                out[px * 3 + 0] = g;
+                out[px * 3 + 1] = g;
+                out[px * 3 + 2] = g;
+            }
+        }
+    });
+}
+
+//++ Renders the preview rows whose source row lies in the world rows [rowBegin, rowEnd) held by tileMap, rgb is the whole preview
+//++ Blocks use their color, air tiles use the darkened color of their wall
+inline void renderTilePreview(const TilePlanes& tileMap, int downscale, int rowBegin, int rowEnd, uint8_t* rgb) {
+    std::array<std::array<uint8_t, 3>, 256> blockColors{};
+    std::array<std::array<uint8_t, 3>, 256> wallColors{};
+    for (int id = 0; id < 256; ++id) {
+        const Color& c = TILES::COLORVALUES::COLORS[id];
+        blockColors[id] = {uint8_t(std::clamp(c.c_r, 0, 255)), uint8_t(std::clamp(c.c_g, 0, 255)), uint8_t(std::clamp(c.c_b, 0, 255))};
+        wallColors[id]  = {uint8_t(std::clamp(c.c_r - 25, 0, 255)), uint8_t(std::clamp(c.c_g - 25, 0, 255)), uint8_t(std::clamp(c.c_b - 25, 0, 255))};
+    }
+
+    const uint8_t air = static_cast<uint8_t>(TILES::BLOCKS::ID::AIR);
+    int width = previewSize(tileMap.sizeX, downscale);
+
+    generationWorkers().parallelFor(previewSize(rowBegin, downscale), previewSize(rowEnd, downscale), 16, [&](int begin, int end) {
+        for (int py = begin; py < end; ++py) {
+            size_t rowIndex = tileMap.indexOf(0, py * downscale);
+            uint8_t* out = rgb + size_t(py) * width * 3;
+            for (int px = 0; px < width; ++px) {
+                size_t index = rowIndex + size_t(px) * downscale;
+                uint8_t block = tileMap.blocks[index];
+                const std::array<uint8_t, 3>& c = block == air ? wallColors[tileMap.walls[index]] : blockColors[block];
+                out[px * 3 + 0] = c[0];
+                out[px * 3 + 1] = c[1];
+                out[px * 3 + 2] = c[2];
+            }
+        }
+    });
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+++ Counter Based Random Numbers for the World Generator
+Every random value is derived from (seed, stage, x, y, draw) with a SplitMix64 style mixer instead of the global rand() state.
+A value therefore never depends on how many values were drawn before it or on which thread draws it,
+so stages can run in any order and on any number of threads and the same seed still gives the same world.
+
+- stage: one of RANDOMSTAGE, separates the streams of different stages
+- x, y:  world position (or column / item index) the value belongs to
+- draw:  index when one position needs several values
+*/
+namespace RANDOMSTAGE {
+    enum ID : uint32_t {
+        NOISE,
+        ORES,
+        SURFACE,
+        TREES,
+        BIOMES,
+        STRUCTURES,
+    };
+}
+
+inline uint64_t mixBits(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct GenerationRandom {
+    uint64_t seed = 0;
+
+    explicit GenerationRandom(int seed_ = 0) : seed(mixBits(uint64_t(uint32_t(seed_)))) {}
+
+    uint64_t bits(uint32_t stage, int x, int y, uint32_t draw = 0) const {
+        uint64_t key = mixBits(seed ^ ((uint64_t(stage) << 32) | draw));
+        return mixBits(key ^ ((uint64_t(uint32_t(x)) << 32) | uint32_t(y)));
+    }
+
+    //++ Value in [0, range), range > 0
+    uint32_t range(uint32_t stage, int x, int y, uint32_t range, uint32_t draw = 0) const {
+        return uint32_t(((bits(stage, x, y, draw) >> 32) * range) >> 32);
+    }
+
+    //++ Batched draws for a row: out[i] = range(stage, xBegin + i, y, range, draw), range <= 256
+    void fillRow(uint32_t stage, int xBegin, int y, uint32_t range, uint32_t draw, uint8_t* out, int count) const {
+        uint64_t key = mixBits(seed ^ ((uint64_t(stage) << 32) | draw));
+        for (int i = 0; i < count; ++i) {
+            uint64_t value = mixBits(key ^ ((uint64_t(uint32_t(xBegin + i)) << 32) | uint32_t(y)));
+            out[i] = uint8_t(((value >> 32) * range) >> 32);
+        }
+    }
+};
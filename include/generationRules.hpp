@@ -0,0 +1,409 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <unordered_map>
+#include <algorithm>
+#include <memory_resource>
+
+#include <nlohmann/json.hpp>
+#include <JFLX/logging.hpp>
+
+#include "tiles.hpp"
+
+/*
+++ Table Driven Layer and Ore Rules
+The rules are read from "gameData/json/generationRules.jsonc" and compiled into lookup tables once at load time:
+- every layer gets 256 entry tables (noise value -> block / wall), so layering a tile is a few table lookups
+- every ore band gets a host table (block ID -> is host) and 100 entry choice tables (roll -> vein)
+- height percents are resolved once per world row (rowLayers / rowOreBands) instead of per tile
+- structure patterns are compiled into block / wall grids with the footprint relative to the seed tile
+*/
+namespace RULES {
+    const std::unordered_map<std::string, TILES::BLOCKS::ID> BLOCKNAMES = {
+        {"ADAMANTITE",     TILES::BLOCKS::ID::ADAMANTITE},
+        {"AIR",            TILES::BLOCKS::ID::AIR},
+        {"ALUMINIUM",      TILES::BLOCKS::ID::ALUMINIUM},
+        {"AMETHYST",       TILES::BLOCKS::ID::AMETHYST},
+        {"ANDESITE",       TILES::BLOCKS::ID::ANDESITE},
+        {"AQUAMARINE",     TILES::BLOCKS::ID::AQUAMARINE},
+        {"BASALT",         TILES::BLOCKS::ID::BASALT},
+        {"BEDROCK",        TILES::BLOCKS::ID::BEDROCK},
+        {"BISMUTH",        TILES::BLOCKS::ID::BISMUTH},
+        {"BRONZE",         TILES::BLOCKS::ID::BRONZE},
+        {"CHALK",          TILES::BLOCKS::ID::CHALK},
+        {"CLAY",           TILES::BLOCKS::ID::CLAY},
+        {"COAL",           TILES::BLOCKS::ID::COAL},
+        {"COBALT",         TILES::BLOCKS::ID::COBALT},
+        {"COPPER",         TILES::BLOCKS::ID::COPPER},
+        {"DIAMOND",        TILES::BLOCKS::ID::DIAMOND},
+        {"DIORITE",        TILES::BLOCKS::ID::DIORITE},
+        {"DIRT",           TILES::BLOCKS::ID::DIRT},
+        {"EMERALD",        TILES::BLOCKS::ID::EMERALD},
+        {"GALENA",         TILES::BLOCKS::ID::GALENA},
+        {"GNEISS",         TILES::BLOCKS::ID::GNEISS},
+        {"GOLD",           TILES::BLOCKS::ID::GOLD},
+        {"GRANITE",        TILES::BLOCKS::ID::GRANITE},
+        {"GRASS",          TILES::BLOCKS::ID::GRASS},
+        {"GRAVEL",         TILES::BLOCKS::ID::GRAVEL},
+        {"HEMATITE",       TILES::BLOCKS::ID::HEMATITE},
+        {"ICEBLOCK",       TILES::BLOCKS::ID::ICEBLOCK},
+        {"IRIDIUM",        TILES::BLOCKS::ID::IRIDIUM},
+        {"IRON",           TILES::BLOCKS::ID::IRON},
+        {"JUNGLEGRASS",    TILES::BLOCKS::ID::JUNGLEGRASS},
+        {"KIMBERLITE",     TILES::BLOCKS::ID::KIMBERLITE},
+        {"LEAD",           TILES::BLOCKS::ID::LEAD},
+        {"LIMESTONE",      TILES::BLOCKS::ID::LIMESTONE},
+        {"MARBLE",         TILES::BLOCKS::ID::MARBLE},
+        {"MITHRILITE",     TILES::BLOCKS::ID::MITHRILITE},
+        {"MUD",            TILES::BLOCKS::ID::MUD},
+        {"ONYX",           TILES::BLOCKS::ID::ONYX},
+        {"ORICHALCUM",     TILES::BLOCKS::ID::ORICHALCUM},
+        {"OSMIUM",         TILES::BLOCKS::ID::OSMIUM},
+        {"PLATINUM",       TILES::BLOCKS::ID::PLATINUM},
+        {"PLUTONIUM",      TILES::BLOCKS::ID::PLUTONIUM},
+        {"QUARTZ",         TILES::BLOCKS::ID::QUARTZ},
+        {"QUARTZITE",      TILES::BLOCKS::ID::QUARTZITE},
+        {"RUBY",           TILES::BLOCKS::ID::RUBY},
+        {"SAPPHIRE",       TILES::BLOCKS::ID::SAPPHIRE},
+        {"SERPENTINITE",   TILES::BLOCKS::ID::SERPENTINITE},
+        {"SHALE",          TILES::BLOCKS::ID::SHALE},
+        {"SILVER",         TILES::BLOCKS::ID::SILVER},
+        {"SLATE",          TILES::BLOCKS::ID::SLATE},
+        {"SNOWDIRT",       TILES::BLOCKS::ID::SNOWDIRT},
+        {"SNOWGRASS",      TILES::BLOCKS::ID::SNOWGRASS},
+        {"TANZANITE",      TILES::BLOCKS::ID::TANZANITE},
+        {"TITANIUM",       TILES::BLOCKS::ID::TITANIUM},
+        {"TOPAZ",          TILES::BLOCKS::ID::TOPAZ},
+        {"TREESEED",       TILES::BLOCKS::ID::TREESEED},
+        {"TUNGSTEN",       TILES::BLOCKS::ID::TUNGSTEN},
+        {"URANIUM",        TILES::BLOCKS::ID::URANIUM},
+        {"ZINC",           TILES::BLOCKS::ID::ZINC},
+    };
+
+    const std::unordered_map<std::string, TILES::WALLS::ID> WALLNAMES = {
+        {"AIR",            TILES::WALLS::ID::AIR},
+        {"ANDESITE",       TILES::WALLS::ID::ANDESITE},
+        {"BASALT",         TILES::WALLS::ID::BASALT},
+        {"BEDROCK",        TILES::WALLS::ID::BEDROCK},
+        {"CHALK",          TILES::WALLS::ID::CHALK},
+        {"CLAY",           TILES::WALLS::ID::CLAY},
+        {"DIORITE",        TILES::WALLS::ID::DIORITE},
+        {"DIRT",           TILES::WALLS::ID::DIRT},
+        {"GNEISS",         TILES::WALLS::ID::GNEISS},
+        {"GRANITE",        TILES::WALLS::ID::GRANITE},
+        {"GRASS",          TILES::WALLS::ID::GRASS},
+        {"GRAVEL",         TILES::WALLS::ID::GRAVEL},
+        {"ICEBLOCK",       TILES::WALLS::ID::ICEBLOCK},
+        {"JUNGLEGRASS",    TILES::WALLS::ID::JUNGLEGRASS},
+        {"KIMBERLITE",     TILES::WALLS::ID::KIMBERLITE},
+        {"LIMESTONE",      TILES::WALLS::ID::LIMESTONE},
+        {"MARBLE",         TILES::WALLS::ID::MARBLE},
+        {"MUD",            TILES::WALLS::ID::MUD},
+        {"QUARTZITE",      TILES::WALLS::ID::QUARTZITE},
+        {"SERPENTINITE",   TILES::WALLS::ID::SERPENTINITE},
+        {"SHALE",          TILES::WALLS::ID::SHALE},
+        {"SLATE",          TILES::WALLS::ID::SLATE},
+        {"SNOWDIRT",       TILES::WALLS::ID::SNOWDIRT},
+        {"SNOWGRASS",      TILES::WALLS::ID::SNOWGRASS},
+    };
+}
+
+struct CompiledLayer {
+    std::string name;
+    int toPercent = 101;
+
+    std::array<uint8_t, 256> solidMask{};   // noise A -> 0xFF block, 0x00 air
+    std::array<uint8_t, 256> rockBlock{};   // noise B -> block ID
+    std::array<uint8_t, 256> rockWall{};    // noise B -> wall ID
+};
+
+struct CompiledVein {
+    TILES::BLOCKS::ID block = TILES::BLOCKS::ID::NOCHANGE;
+    TILES::WALLS::ID wall   = TILES::WALLS::ID::NOCHANGE;
+    int spread              = 1;
+    bool replaceAir         = false;
+};
+
+struct CompiledOreBand {
+    std::string name;
+    int toPercent = 101;
+
+    std::array<uint8_t, 256> host{};           // block ID -> 1 when veins may start on it
+    std::vector<CompiledVein> ores;
+    std::vector<CompiledVein> gems;
+    std::array<uint8_t, 100> oreChoice{};      // roll -> index into ores
+    std::array<uint8_t, 100> gemChoice{};      // roll -> index into gems
+};
+
+//++ One pattern of a structure, tiles with NOCHANGE for block and wall are not part of the footprint
+struct StructureVariant {
+    int width   = 0;
+    int height  = 0;
+    int anchorX = 0;
+    int anchorY = 0;
+    std::vector<uint8_t> blocks;
+    std::vector<uint8_t> walls;
+
+    //++ Footprint bounding box relative to the anchor (inclusive)
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+};
+
+struct CompiledStructure {
+    std::string name;
+    std::array<uint8_t, 256> replaceable{};    // block ID -> 1 when the structure may be placed over it
+    int spacing = 0;                            // free tiles kept between two structures
+    std::vector<StructureVariant> variants;
+
+    //++ Largest distance of a footprint tile (plus spacing) from the anchor
+    int extent = 0;
+};
+
+struct GenerationRules {
+    std::vector<CompiledLayer> layers;
+    std::vector<CompiledOreBand> oreBands;
+    std::vector<CompiledStructure> structures;
+
+    int veinMin      = 0;
+    int veinMax      = 75;
+    int oreRollRange = 12;
+    int gemBelowRoll = 3;
+};
+
+inline GenerationRules generationRules;
+
+inline bool ruleBlockID(const std::string& name, TILES::BLOCKS::ID& id) {
+    auto it = RULES::BLOCKNAMES.find(name);
+    if (it == RULES::BLOCKNAMES.end()) {
+        JFLX::log("Generation Rules: ", "Unknown block name: " + name, JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+inline bool ruleWallID(const std::string& name, TILES::WALLS::ID& id) {
+    auto it = RULES::WALLNAMES.find(name);
+    if (it == RULES::WALLNAMES.end()) {
+        JFLX::log("Generation Rules: ", "Unknown wall name: " + name, JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+//++ Compiles a list of {"upTo", ...} entries into a roll -> index table, the last entry covers every remaining roll
+inline bool compileVeins(const nlohmann::json& list, std::vector<CompiledVein>& veins, std::array<uint8_t, 100>& choice) {
+    int roll = 0;
+    for (const auto& entry : list) {
+        CompiledVein vein;
+        if (!ruleBlockID(entry.at("block").get<std::string>(), vein.block)) return false;
+        if (entry.contains("wall") && !ruleWallID(entry["wall"].get<std::string>(), vein.wall)) return false;
+        vein.spread     = std::max(1, entry.value("spread", 1));
+        vein.replaceAir = entry.value("replaceAir", false);
+
+        int upTo = (&entry == &list.back()) ? 99 : std::min(99, entry.value("upTo", 99));
+        for (; roll <= upTo; ++roll) {
+            choice[roll] = static_cast<uint8_t>(veins.size());
+        }
+        veins.push_back(vein);
+    }
+    return true;
+}
+
+//++ Compiles {"replaceable", "spacing", "legend", "variants":[{"anchor", "pattern"}]}, "." and unknown legend characters keep the tile
+inline bool compileStructure(const std::string& name, const nlohmann::json& data, CompiledStructure& structure) {
+    structure.name    = name;
+    structure.spacing = std::max(0, data.value("spacing", 0));
+
+    for (const auto& blockName : data.at("replaceable")) {
+        TILES::BLOCKS::ID block;
+        if (!ruleBlockID(blockName.get<std::string>(), block)) return false;
+        structure.replaceable[static_cast<uint8_t>(block)] = 1;
+    }
+
+    std::array<uint8_t, 256> legendBlock;
+    std::array<uint8_t, 256> legendWall;
+    legendBlock.fill(static_cast<uint8_t>(TILES::BLOCKS::ID::NOCHANGE));
+    legendWall.fill(static_cast<uint8_t>(TILES::WALLS::ID::NOCHANGE));
+    for (const auto& [key, tile] : data.at("legend").items()) {
+        if (key.size() != 1) {
+            JFLX::log("Generation Rules: ", "Legend keys of structure " + name + " must be single characters: " + key, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+        uint8_t c = static_cast<uint8_t>(key[0]);
+        TILES::BLOCKS::ID block = TILES::BLOCKS::ID::NOCHANGE;
+        TILES::WALLS::ID wall   = TILES::WALLS::ID::NOCHANGE;
+        if (tile.contains("block") && !ruleBlockID(tile["block"].get<std::string>(), block)) return false;
+        if (tile.contains("wall") && !ruleWallID(tile["wall"].get<std::string>(), wall)) return false;
+        legendBlock[c] = static_cast<uint8_t>(block);
+        legendWall[c]  = static_cast<uint8_t>(wall);
+    }
+
+    const uint8_t noBlock = static_cast<uint8_t>(TILES::BLOCKS::ID::NOCHANGE);
+    const uint8_t noWall  = static_cast<uint8_t>(TILES::WALLS::ID::NOCHANGE);
+    for (const auto& variantData : data.at("variants")) {
+        StructureVariant variant;
+        const auto& pattern = variantData.at("pattern");
+        variant.height  = int(pattern.size());
+        variant.width   = variant.height > 0 ? int(pattern[0].get<std::string>().size()) : 0;
+        variant.anchorX = variantData.at("anchor").at(0).get<int>();
+        variant.anchorY = variantData.at("anchor").at(1).get<int>();
+
+        if (variant.anchorX < 0 || variant.anchorX >= variant.width || variant.anchorY < 0 || variant.anchorY >= variant.height) {
+            JFLX::log("Generation Rules: ", "Anchor outside of the pattern in structure " + name, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+
+        variant.minX = variant.minY = 0;
+        variant.maxX = variant.maxY = 0;
+        for (int y = 0; y < variant.height; ++y) {
+            std::string row = pattern[y].get<std::string>();
+            if (int(row.size()) != variant.width) {
+                JFLX::log("Generation Rules: ", "Pattern rows of structure " + name + " differ in length", JFLX::LOGTYPE::ERROR);
+                return false;
+            }
+            for (int x = 0; x < variant.width; ++x) {
+                uint8_t block = legendBlock[static_cast<uint8_t>(row[x])];
+                uint8_t wall  = legendWall[static_cast<uint8_t>(row[x])];
+                variant.blocks.push_back(block);
+                variant.walls.push_back(wall);
+                if (block == noBlock && wall == noWall) continue;
+
+                variant.minX = std::min(variant.minX, x - variant.anchorX);
+                variant.maxX = std::max(variant.maxX, x - variant.anchorX);
+                variant.minY = std::min(variant.minY, y - variant.anchorY);
+                variant.maxY = std::max(variant.maxY, y - variant.anchorY);
+            }
+        }
+
+        structure.extent = std::max({structure.extent, -variant.minX, variant.maxX, -variant.minY, variant.maxY});
+        structure.variants.push_back(variant);
+    }
+    structure.extent += structure.spacing;
+
+    if (structure.variants.empty()) {
+        JFLX::log("Generation Rules: ", "Structure " + name + " has no variants", JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    return true;
+}
+
+inline const CompiledStructure* findStructure(const GenerationRules& rules, const std::string& name) {
+    for (const CompiledStructure& structure : rules.structures) {
+        if (structure.name == name) return &structure;
+    }
+    return nullptr;
+}
+
+inline bool loadGenerationRules(const std::string& rulesPath, GenerationRules& rules) {
+    std::ifstream file(rulesPath);
+    if (!file.is_open()) {
+        JFLX::log("Generation Rules: ", "Failed to open " + rulesPath, JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+
+    nlohmann::json data;
+    try {
+        data = nlohmann::json::parse(file, nullptr, true, true); //-> allow comments (.jsonc)
+
+        rules = GenerationRules{};
+
+        //++ Layers
+        for (const auto& layerData : data.at("layers")) {
+            CompiledLayer layer;
+            layer.name      = layerData.value("name", "");
+            layer.toPercent = layerData.at("to").get<int>();
+
+            int solidBelow = layerData.value("solidBelow", 0);
+            for (int v = 0; v < 256; ++v) {
+                layer.solidMask[v] = v < solidBelow ? 0xFF : 0x00;
+            }
+
+            int value = 0;
+            const auto& rocks = layerData.at("rocks");
+            for (const auto& rock : rocks) {
+                TILES::BLOCKS::ID block;
+                TILES::WALLS::ID wall;
+                if (!ruleBlockID(rock.at("block").get<std::string>(), block)) return false;
+                if (!ruleWallID(rock.at("wall").get<std::string>(), wall)) return false;
+
+                int below = (&rock == &rocks.back()) ? 256 : std::min(256, rock.value("below", 256));
+                for (; value < below; ++value) {
+                    layer.rockBlock[value] = static_cast<uint8_t>(block);
+                    layer.rockWall[value]  = static_cast<uint8_t>(wall);
+                }
+            }
+            rules.layers.push_back(layer);
+        }
+
+        //++ Fallback for heights below every layer: air
+        CompiledLayer airLayer;
+        airLayer.name = "none";
+        airLayer.rockBlock.fill(static_cast<uint8_t>(TILES::BLOCKS::ID::AIR));
+        airLayer.rockWall.fill(static_cast<uint8_t>(TILES::WALLS::ID::AIR));
+        rules.layers.push_back(airLayer);
+
+        //++ Ores
+        const auto& ores = data.at("ores");
+        rules.veinMin      = ores.value("veinMin", 0);
+        rules.veinMax      = ores.value("veinMax", 75);
+        rules.oreRollRange = std::clamp(ores.value("oreRollRange", 12), 1, 256);
+        rules.gemBelowRoll = ores.value("gemBelowRoll", 3);
+
+        for (const auto& bandData : ores.at("bands")) {
+            CompiledOreBand band;
+            band.name      = bandData.value("name", "");
+            band.toPercent = bandData.at("to").get<int>();
+
+            for (const auto& hostName : bandData.value("hosts", nlohmann::json::array())) {
+                TILES::BLOCKS::ID host;
+                if (!ruleBlockID(hostName.get<std::string>(), host)) return false;
+                band.host[static_cast<uint8_t>(host)] = 1;
+            }
+
+            if (!compileVeins(bandData.value("ores", nlohmann::json::array()), band.ores, band.oreChoice)) return false;
+            if (!compileVeins(bandData.value("gems", nlohmann::json::array()), band.gems, band.gemChoice)) return false;
+            rules.oreBands.push_back(band);
+        }
+
+        //++ Fallback for heights below every ore band: no veins
+        CompiledOreBand noBand;
+        noBand.name = "none";
+        rules.oreBands.push_back(noBand);
+
+        //++ Structures (optional)
+        nlohmann::json structures = data.value("structures", nlohmann::json::object());
+        for (const auto& [name, structureData] : structures.items()) {
+            CompiledStructure structure;
+            if (!compileStructure(name, structureData, structure)) return false;
+            rules.structures.push_back(structure);
+        }
+    } catch (const nlohmann::json::exception& e) {
+        JFLX::log("Generation Rules: ", std::string("Invalid rules file: ") + e.what(), JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+
+    JFLX::log("Generation Rules: ", "Loaded " + std::to_string(rules.layers.size() - 1) + " layers, " + std::to_string(rules.oreBands.size() - 1) + " ore bands and " + std::to_string(rules.structures.size()) + " structures", JFLX::LOGTYPE::SUCCESS);
+    return true;
+}
+
+//++ Resolves the height percent of every world row once: row -> layer index / ore band index
+template <typename Entry>
+inline std::pmr::vector<uint8_t> compileRowTable(const std::vector<Entry>& entries, int sizeY, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    std::pmr::vector<uint8_t> rows(sizeY, resource);
+    for (int y = 0; y < sizeY; ++y) {
+        int percent = int((int64_t(y) * 100) / sizeY);
+
+        size_t entry = 0;
+        while (entry + 1 < entries.size() && percent > entries[entry].toPercent) {
+            ++entry;
+        }
+        rows[y] = static_cast<uint8_t>(entry);
+    }
+    return rows;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+#include "tiles.hpp"
+#include "generationPlanes.hpp"
+#include "generationRules.hpp"
+#include "generationRandom.hpp"
+#include "generationWorkers.hpp"
+#include "generationArena.hpp"
+
+/*
+++ Structure Placement
+Grows structures (trees, later props / furniture) from seed tiles.
+
+The held rows are split into square regions at least twice the structure extent wide, so a structure only touches its own region and the neighbours.
+Regions are processed in 4 phases (region x / y parity), the regions of one phase never share a tile and run in parallel.
+Inside a region the seeds are placed top to bottom, left to right. The result never depends on the thread count.
+
+A seed is placed when every footprint tile (except the seed tile) holds a replaceable block, lies inside the held rows
+and the footprint (grown by the spacing) does not touch an already placed structure. Otherwise the seed tile is cleared.
+*/
+struct StructureBox {
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+};
+
+inline bool boxesTouch(const StructureBox& a, const StructureBox& b, int spacing) {
+    return a.minX <= b.maxX + spacing && b.minX <= a.maxX + spacing && a.minY <= b.maxY + spacing && b.minY <= a.maxY + spacing;
+}
+
+struct StructureRegions {
+    int regionSize = 64;
+    int regionsX   = 0;
+    int regionsY   = 0;
+    int firstY     = 0;   // world row of region row 0
+
+    //++ placed[region] = footprints placed with their anchor in that region
+    std::vector<std::vector<StructureBox>> placed;
+
+    int regionOf(int x, int y) const {
+        return ((y - firstY) / regionSize) * regionsX + x / regionSize;
+    }
+};
+
+inline bool tryPlaceStructure(TilePlanes& tileMap, const CompiledStructure& structure, const StructureVariant& variant, int x, int y, StructureRegions& regions, int region) {
+    StructureBox box = {x + variant.minX, y + variant.minY, x + variant.maxX, y + variant.maxY};
+
+    //++ Conflicts with structures in the 3x3 neighbourhood (only the own region is written in this phase)
+    int rx = region % regions.regionsX;
+    int ry = region / regions.regionsX;
+    for (int ny = std::max(0, ry - 1); ny <= std::min(regions.regionsY - 1, ry + 1); ++ny) {
+        for (int nx = std::max(0, rx - 1); nx <= std::min(regions.regionsX - 1, rx + 1); ++nx) {
+            for (const StructureBox& other : regions.placed[ny * regions.regionsX + nx]) {
+                if (boxesTouch(box, other, structure.spacing)) return false;
+            }
+        }
+    }
+
+    const uint8_t noBlock = static_cast<uint8_t>(TILES::BLOCKS::ID::NOCHANGE);
+    const uint8_t noWall  = static_cast<uint8_t>(TILES::WALLS::ID::NOCHANGE);
+
+    //++ Every footprint tile has to be held and replaceable
+    for (int py = 0; py < variant.height; ++py) {
+        for (int px = 0; px < variant.width; ++px) {
+            size_t cell = size_t(py) * variant.width + px;
+            if (variant.blocks[cell] == noBlock && variant.walls[cell] == noWall) continue;
+
+            int wx = x - variant.anchorX + px;
+            int wy = y - variant.anchorY + py;
+            if (!tileMap.holds(wx, wy)) return false;
+            if (px == variant.anchorX && py == variant.anchorY) continue;
+            if (!structure.replaceable[tileMap.blocks[tileMap.indexOf(wx, wy)]]) return false;
+        }
+    }
+
+    for (int py = 0; py < variant.height; ++py) {
+        for (int px = 0; px < variant.width; ++px) {
+            size_t cell = size_t(py) * variant.width + px;
+            if (variant.blocks[cell] == noBlock && variant.walls[cell] == noWall) continue;
+
+            size_t index = tileMap.indexOf(x - variant.anchorX + px, y - variant.anchorY + py);
+            tileMap.set(index, static_cast<TILES::BLOCKS::ID>(variant.blocks[cell]), static_cast<TILES::WALLS::ID>(variant.walls[cell]));
+        }
+    }
+
+    regions.placed[region].push_back(box);
+    return true;
+}
+
+//++ Places the structure on every seed held by tileMap, returns the number of placed structures
+inline int placeStructures(TilePlanes& tileMap, const CompiledStructure& structure, const std::vector<std::array<int, 2>>& seeds, const GenerationRandom& random) {
+    if (seeds.empty() || tileMap.sizeY <= 0) return 0;
+
+    StructureRegions regions;
+    regions.regionSize = std::max(64, 2 * structure.extent + 2);
+    regions.regionsX   = (tileMap.sizeX + regions.regionSize - 1) / regions.regionSize;
+    regions.regionsY   = (tileMap.sizeY + regions.regionSize - 1) / regions.regionSize;
+    regions.firstY     = tileMap.originY;
+    regions.placed.resize(size_t(regions.regionsX) * regions.regionsY);
+
+    //++ Bucket the held seeds by region, ordered top to bottom / left to right inside a region
+    struct RegionSeed {
+        int region;
+        int x, y;
+    };
+    GenerationArena& arena = generationArena();
+    ArenaMarker scratch = arena.mark();
+
+    ArenaVector<RegionSeed> ordered(&arena);
+    ordered.reserve(seeds.size());
+    for (const std::array<int, 2>& seed : seeds) {
+        if (tileMap.holds(seed[0], seed[1])) {
+            ordered.push_back({regions.regionOf(seed[0], seed[1]), seed[0], seed[1]});
+        }
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const RegionSeed& a, const RegionSeed& b) {
+        if (a.region != b.region) return a.region < b.region;
+        if (a.y != b.y) return a.y < b.y;
+        return a.x < b.x;
+    });
+
+    ArenaVector<size_t> regionStart(regions.placed.size() + 1, 0, &arena);
+    for (const RegionSeed& seed : ordered) {
+        ++regionStart[seed.region + 1];
+    }
+    for (size_t r = 1; r < regionStart.size(); ++r) {
+        regionStart[r] += regionStart[r - 1];
+    }
+
+    std::atomic<int> placedCount{0};
+    for (int phase = 0; phase < 4; ++phase) {
+        ArenaVector<int> phaseRegions(&arena);
+        for (int ry = phase / 2; ry < regions.regionsY; ry += 2) {
+            for (int rx = phase % 2; rx < regions.regionsX; rx += 2) {
+                int region = ry * regions.regionsX + rx;
+                if (regionStart[region] != regionStart[region + 1]) phaseRegions.push_back(region);
+            }
+        }
+
+        generationWorkers().parallelFor(0, int(phaseRegions.size()), 1, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                int region = phaseRegions[i];
+                int placedHere = 0;
+                for (size_t s = regionStart[region]; s < regionStart[region + 1]; ++s) {
+                    const RegionSeed& seed = ordered[s];
+                    const StructureVariant& variant = structure.variants[random.range(RANDOMSTAGE::STRUCTURES, seed.x, seed.y, uint32_t(structure.variants.size()))];
+
+                    if (tryPlaceStructure(tileMap, structure, variant, seed.x, seed.y, regions, region)) {
+                        ++placedHere;
+                    } else {
+                        size_t index = tileMap.indexOf(seed.x, seed.y);
+                        if (tileMap.block(index) == TILES::BLOCKS::ID::TREESEED) {
+                            tileMap.set(index, TILES::BLOCKS::ID::AIR);
+                        }
+                    }
+                }
+                placedCount += placedHere;
+            }
+        });
+    }
+
+    //++ placed[] lives on the heap, it is filled inside the parallel jobs
+    arena.rewind(scratch);
+    return placedCount.load();
+}
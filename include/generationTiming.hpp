@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+
+#include <JFLX/logging.hpp>
+
+/*
+++ Stage Timing
+start() at the beginning of a world, lap("stage") after every stage: the time since the last lap is added to that stage.
+Laps with the same name are summed up, so the stages of a streamed world report their total over all bands.
+peakMemory / largePages are filled in from the generation arena before report().
+*/
+struct StageTimings {
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage {
+        std::string name;
+        double milliseconds = 0.0;
+    };
+
+    std::vector<Stage> stages;
+    Clock::time_point worldStart;
+    Clock::time_point lastLap;
+    size_t peakMemory = 0;
+    bool largePages   = false;
+
+    void start() {
+        stages.clear();
+        peakMemory = 0;
+        largePages = false;
+        worldStart = lastLap = Clock::now();
+    }
+
+    void lap(const std::string& name) {
+        Clock::time_point now = Clock::now();
+        double milliseconds = std::chrono::duration<double, std::milli>(now - lastLap).count();
+        lastLap = now;
+
+        for (Stage& stage : stages) {
+            if (stage.name == name) {
+                stage.milliseconds += milliseconds;
+                return;
+            }
+        }
+        stages.push_back({name, milliseconds});
+    }
+
+    double totalMilliseconds() const {
+        return std::chrono::duration<double, std::milli>(lastLap - worldStart).count();
+    }
+
+    void report(const std::string& worldName) const {
+        double total = totalMilliseconds();
+        JFLX::log("World Generation: ", "Stage timings of " + worldName + ":", JFLX::LOGTYPE::INFO);
+        for (const Stage& stage : stages) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "  %-12s %10.1f ms %6.1f %%", stage.name.c_str(), stage.milliseconds, total > 0.0 ? stage.milliseconds * 100.0 / total : 0.0);
+            JFLX::log("World Generation: ", line, JFLX::LOGTYPE::INFO);
+        }
+        char line[128];
+        std::snprintf(line, sizeof(line), "  %-12s %10.1f ms", "total", total);
+        JFLX::log("World Generation: ", line, JFLX::LOGTYPE::INFO);
+        std::snprintf(line, sizeof(line), "  %-12s %10.1f MiB%s", "peak memory", double(peakMemory) / (1024.0 * 1024.0), largePages ? " (large pages)" : "");
+        JFLX::log("World Generation: ", line, JFLX::LOGTYPE::INFO);
+    }
+};
+
+inline StageTimings generationTimings;
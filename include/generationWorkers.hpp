@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+++ Worker Pool for the World Generator
+A fixed set of threads that is created once and reused by every parallel stage (and every world in a batch).
+parallelFor splits [begin, end) into chunks of "grain" items, the calling thread works on chunks as well.
+Results never depend on the thread count as long as every chunk only writes its own rows / items.
+
+!! parallelFor is not reentrant: calls from inside a running job are executed serially on the calling thread !!
+*/
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned threadCount = std::thread::hardware_concurrency()) {
+        threadCount = std::max(1u, threadCount);
+        for (unsigned i = 1; i < threadCount; ++i) {
+            threads.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeWorkers.notify_all();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const {
+        return unsigned(threads.size()) + 1;
+    }
+
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn) {
+        if (end <= begin) return;
+        grain = std::max(1, grain);
+
+        if (insideJob || threads.empty() || end - begin <= grain) {
+            fn(begin, end);
+            return;
+        }
+
+        std::lock_guard<std::mutex> callLock(callMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobFunction = &fn;
+            jobEnd      = end;
+            jobGrain    = grain;
+            nextItem.store(begin);
+            activeWorkers = unsigned(threads.size());
+            ++jobGeneration;
+        }
+        wakeWorkers.notify_all();
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        jobDone.wait(lock, [this]() { return activeWorkers == 0; });
+        jobFunction = nullptr;
+    }
+
+private:
+    std::vector<std::thread> threads;
+
+    std::mutex callMutex;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable jobDone;
+
+    const std::function<void(int, int)>* jobFunction = nullptr;
+    int jobEnd   = 0;
+    int jobGrain = 1;
+    std::atomic<int> nextItem{0};
+    unsigned activeWorkers = 0;
+    uint64_t jobGeneration = 0;
+    bool stopping = false;
+
+    static inline thread_local bool insideJob = false;
+
+    void runChunks() {
+        insideJob = true;
+        while (true) {
+            int chunkBegin = nextItem.fetch_add(jobGrain);
+            if (chunkBegin >= jobEnd) break;
+            (*jobFunction)(chunkBegin, std::min(jobEnd, chunkBegin + jobGrain));
+        }
+        insideJob = false;
+    }
+
+    void workerLoop() {
+        uint64_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeWorkers.wait(lock, [&]() { return stopping || jobGeneration != seenGeneration; });
+                if (stopping) return;
+                seenGeneration = jobGeneration;
+            }
+
+            runChunks();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--activeWorkers == 0) {
+                jobDone.notify_one();
+            }
+        }
+    }
+};
+
+//++ The pool shared by all generation stages, created on first use
+inline WorkerPool& generationWorkers() {
+    static WorkerPool pool;
+    return pool;
+}
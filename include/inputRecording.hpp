@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <array>
+#include <fstream>
+
+#include <SDL3/SDL.h>
+#include <JFLX/logging.hpp>
+
+/*
+++ Input Recording / Replay
+The simulation runs in fixed steps, every input event is handled at the start of a step. A session is recorded as the
+world seed, the level and every handled event with the number of its step: replaying the events at the same steps
+runs the same session again, independent of the frame rate of the machine it runs on.
+
+- Keys are recorded as scancodes, the simulation reads held keys from InputState (not SDL_GetKeyboardState)
+- Mouse positions are recorded in virtual coordinates (presentation.hpp), a replay does not depend on the window size
+- Key repeats are not recorded, they do not change the held keys
+
+File (little endian): magic, version, step length (microseconds), world seed, level | events, the last one is END
+Event: step delta to the event before (varint) | type (1 byte) | code (varint) | x, y (int16, mouse events only)
+*/
+static constexpr uint32_t INPUT_MAGIC   = 0x52494242; // "BBIR"
+static constexpr uint32_t INPUT_VERSION = 1;
+
+enum class INPUTTYPE : uint8_t {
+    KEYDOWN,
+    KEYUP,
+    MOUSEUP,
+    MOUSEMOVE,
+    END
+};
+
+struct InputEvent {
+    uint32_t step  = 0;
+    INPUTTYPE type = INPUTTYPE::END;
+    uint16_t code  = 0;   // scancode / mouse button
+    int16_t x      = 0;   // virtual coordinates (mouse)
+    int16_t y      = 0;
+
+    bool isMouse() const {
+        return type == INPUTTYPE::MOUSEUP || type == INPUTTYPE::MOUSEMOVE;
+    }
+};
+
+struct InputSession {
+    uint32_t stepMicroseconds = 0;
+    uint32_t worldSeed        = 0;
+    std::string level;
+};
+
+//++ Held keys of the simulation, changed only by handled (live or replayed) events
+struct InputState {
+    std::array<bool, SDL_SCANCODE_COUNT> held{};
+
+    void apply(const InputEvent& inputEvent) {
+        if (inputEvent.code >= held.size()) return;
+        if (inputEvent.type == INPUTTYPE::KEYDOWN) held[inputEvent.code] = true;
+        if (inputEvent.type == INPUTTYPE::KEYUP)   held[inputEvent.code] = false;
+    }
+
+    bool down(SDL_Scancode scancode) const {
+        return size_t(scancode) < held.size() && held[scancode];
+    }
+
+    void clear() {
+        held.fill(false);
+    }
+};
+
+namespace inputFile {
+    inline void writeVarint(std::ofstream& file, uint32_t value) {
+        while (value >= 0x80) {
+            file.put(char(uint8_t(value) | 0x80));
+            value >>= 7;
+        }
+        file.put(char(value));
+    }
+
+    inline bool readVarint(std::ifstream& file, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            int byte = file.get();
+            if (byte == EOF) return false;
+            value |= uint32_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    template<typename T>
+    void writeRaw(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template<typename T>
+    bool readRaw(std::ifstream& file, T& value) {
+        return bool(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+}
+
+class InputRecorder {
+public:
+    ~InputRecorder() {
+        if (file.is_open()) file.close();
+    }
+
+    bool start(const std::string& filePath, const InputSession& session) {
+        file.open(filePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            JFLX::log("Input Recorder: ", "Failed to open " + filePath, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+        inputFile::writeRaw(file, INPUT_MAGIC);
+        inputFile::writeRaw(file, INPUT_VERSION);
+        inputFile::writeRaw(file, session.stepMicroseconds);
+        inputFile::writeRaw(file, session.worldSeed);
+        inputFile::writeVarint(file, uint32_t(session.level.size()));
+        file.write(session.level.data(), std::streamsize(session.level.size()));
+
+        lastStep = 0;
+        events   = 0;
+        JFLX::log("Input Recorder: ", "Recording to " + filePath, JFLX::LOGTYPE::INFO);
+        return true;
+    }
+
+    bool recording() const {
+        return file.is_open();
+    }
+
+    void add(const InputEvent& inputEvent) {
+        if (!file.is_open()) return;
+        inputFile::writeVarint(file, inputEvent.step - lastStep);
+        file.put(char(inputEvent.type));
+        inputFile::writeVarint(file, inputEvent.code);
+        if (inputEvent.isMouse()) {
+            inputFile::writeRaw(file, inputEvent.x);
+            inputFile::writeRaw(file, inputEvent.y);
+        }
+        lastStep = inputEvent.step;
+        ++events;
+    }
+
+    //++ Writes the END event at step (the length of the session) and closes the file
+    void finish(uint32_t step) {
+        if (!file.is_open()) return;
+        add({step, INPUTTYPE::END});
+        file.close();
+        JFLX::log("Input Recorder: ", "Recorded " + std::to_string(events - 1) + " events over " + std::to_string(step) + " steps", JFLX::LOGTYPE::SUCCESS);
+    }
+
+private:
+    std::ofstream file;
+    uint32_t lastStep = 0;
+    size_t events     = 0;
+};
+
+class InputReplay {
+public:
+    InputSession session;
+
+    //++ Reads the whole file, false (nothing loaded) when it is missing or broken
+    bool load(const std::string& filePath) {
+        events.clear();
+        next = 0;
+
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            JFLX::log("Input Replay: ", "Failed to open " + filePath, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+
+        uint32_t magic = 0, version = 0, levelLength = 0;
+        if (!inputFile::readRaw(file, magic) || magic != INPUT_MAGIC || !inputFile::readRaw(file, version) || version != INPUT_VERSION) {
+            JFLX::log("Input Replay: ", "Not a recording of this version: " + filePath, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+        if (!inputFile::readRaw(file, session.stepMicroseconds) || !inputFile::readRaw(file, session.worldSeed) || !inputFile::readVarint(file, levelLength) || levelLength > 256) {
+            JFLX::log("Input Replay: ", "Broken header in " + filePath, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+        session.level.resize(levelLength);
+        file.read(session.level.data(), std::streamsize(levelLength));
+
+        uint32_t step = 0;
+        while (true) {
+            InputEvent inputEvent;
+            uint32_t delta = 0, code = 0;
+            int type = 0;
+            if (!inputFile::readVarint(file, delta) || (type = file.get()) == EOF || type > int(INPUTTYPE::END) || !inputFile::readVarint(file, code)) break;
+
+            step += delta;
+            inputEvent.step = step;
+            inputEvent.type = INPUTTYPE(type);
+            inputEvent.code = uint16_t(code);
+            if (inputEvent.isMouse() && (!inputFile::readRaw(file, inputEvent.x) || !inputFile::readRaw(file, inputEvent.y))) break;
+
+            events.push_back(inputEvent);
+            if (inputEvent.type == INPUTTYPE::END) break;
+        }
+
+        //-> A recording that was cut off (crash) replays up to its last event
+        if (events.empty() || events.back().type != INPUTTYPE::END) {
+            JFLX::log("Input Replay: ", "Recording has no end, replaying up to its last event", JFLX::LOGTYPE::WARNING);
+            events.push_back({events.empty() ? 0 : events.back().step, INPUTTYPE::END});
+        }
+
+        JFLX::log("Input Replay: ", "Loaded " + std::to_string(events.size() - 1) + " events over " + std::to_string(endStep()) + " steps from " + filePath, JFLX::LOGTYPE::SUCCESS);
+        return true;
+    }
+
+    bool loaded() const {
+        return !events.empty();
+    }
+
+    //++ Step of the END event
+    uint32_t endStep() const {
+        return events.empty() ? 0 : events.back().step;
+    }
+
+    //++ Appends the events of step (and earlier ones that were not taken yet), END is never returned
+    void take(uint32_t step, std::vector<InputEvent>& out) {
+        while (next < events.size() && events[next].step <= step && events[next].type != INPUTTYPE::END) {
+            out.push_back(events[next++]);
+        }
+    }
+
+    bool finished(uint32_t step) const {
+        return loaded() && step >= endStep();
+    }
+
+private:
+    std::vector<InputEvent> events;
+    size_t next = 0;
+};
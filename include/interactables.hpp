@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "objectMapping.hpp"
+
+/*
+++ Interactable State of a Chunk
+Almost no tile of a chunk holds loot or decoration, so this state is not part of Tile but kept per chunk in small arrays
+sorted by the tile index (y * CHUNKSIZE + x):
+
+- searched: tiles the player searched, with the items still lying in them
+- decor:    tiles with a decoration
+
+Whether a tile can be searched follows from the tile itself (lockers / shelves), see Tile::searchable().
+Loot is rolled when a tile is searched for the first time, from the chunk seed and the tile index only,
+so an unvisited chunk never rolls loot and a searched tile always held the same items.
+*/
+static constexpr int LOOT_SLOTS = 3;
+
+enum class LOOTKIND : uint8_t {
+    LOCKER,
+    SHELF
+};
+
+//++ Item pool of a level ("possibleItems" in levelData), "" is a slot that stays empty
+struct LootTable {
+    std::vector<uint16_t> items;
+
+    void build(const std::vector<std::string>& possibleItems) {
+        items.clear();
+        for (const std::string& name : possibleItems) {
+            if (name.empty()) {
+                items.push_back(uint16_t(objectIDs::EMPTY));
+                continue;
+            }
+            uint16_t id = objectRegistry.id(name);
+            if (id == uint16_t(objectIDs::UNKNOWN)) {
+                JFLX::log("Loot: ", "Unknown item in possibleItems: " + name, JFLX::LOGTYPE::WARNING);
+                continue;
+            }
+            items.push_back(id);
+        }
+    }
+};
+
+struct SearchedTile {
+    uint8_t tile = 0;
+    std::array<uint16_t, LOOT_SLOTS> items{};   // objectIDs::EMPTY = slot taken / empty
+
+    bool empty() const {
+        return std::all_of(items.begin(), items.end(), [](uint16_t item) { return item == uint16_t(objectIDs::EMPTY); });
+    }
+};
+
+struct TileDecor {
+    uint8_t tile = 0;
+    uint8_t decorID = 0;
+};
+
+inline uint32_t chunkSeed(uint32_t worldSeed, int chunkX, int chunkY) {
+    uint32_t h = worldSeed ^ (uint32_t(chunkX) * 0x9E3779B1u) ^ (uint32_t(chunkY) * 0x85EBCA77u);
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+//++ Loot of one tile, only depends on the chunk seed, the tile and its kind
+inline std::array<uint16_t, LOOT_SLOTS> rollLoot(uint32_t seed, uint8_t tile, LOOTKIND kind, const LootTable& table) {
+    std::array<uint16_t, LOOT_SLOTS> items;
+    items.fill(uint16_t(objectIDs::EMPTY));
+    if (table.items.empty()) return items;
+
+    //-> Shelves hold less than lockers
+    int slots = kind == LOOTKIND::LOCKER ? LOOT_SLOTS : LOOT_SLOTS - 1;
+    uint32_t h = seed ^ (uint32_t(tile) * 0xC2B2AE35u);
+    for (int slot = 0; slot < slots; ++slot) {
+        h ^= h >> 16;
+        h *= 0x21F0AAADu;
+        h ^= h >> 15;
+        items[slot] = table.items[h % table.items.size()];
+    }
+    return items;
+}
+
+struct ChunkInteractables {
+    std::vector<SearchedTile> searched;   // sorted by tile
+    std::vector<TileDecor> decor;         // sorted by tile
+
+    //++ nullptr when the tile was never searched
+    SearchedTile* findSearched(uint8_t tile) {
+        auto it = std::lower_bound(searched.begin(), searched.end(), tile, [](const SearchedTile& s, uint8_t t) { return s.tile < t; });
+        return it != searched.end() && it->tile == tile ? &*it : nullptr;
+    }
+
+    bool wasSearched(uint8_t tile) {
+        return findSearched(tile) != nullptr;
+    }
+
+    //++ Searches the tile, the loot is rolled on the first search
+    SearchedTile& search(uint8_t tile, LOOTKIND kind, uint32_t seed, const LootTable& table) {
+        auto it = std::lower_bound(searched.begin(), searched.end(), tile, [](const SearchedTile& s, uint8_t t) { return s.tile < t; });
+        if (it != searched.end() && it->tile == tile) return *it;
+
+        SearchedTile state;
+        state.tile  = tile;
+        state.items = rollLoot(seed, tile, kind, table);
+        return *searched.insert(it, state);
+    }
+
+    //++ Takes the item of a slot, returns objectIDs::EMPTY when there was none
+    uint16_t take(uint8_t tile, int slot) {
+        SearchedTile* state = findSearched(tile);
+        if (!state || slot < 0 || slot >= LOOT_SLOTS) return uint16_t(objectIDs::EMPTY);
+
+        uint16_t item = state->items[slot];
+        state->items[slot] = uint16_t(objectIDs::EMPTY);
+        return item;
+    }
+
+    //++ 0 = no decoration
+    uint8_t decorAt(uint8_t tile) const {
+        auto it = std::lower_bound(decor.begin(), decor.end(), tile, [](const TileDecor& d, uint8_t t) { return d.tile < t; });
+        return it != decor.end() && it->tile == tile ? it->decorID : 0;
+    }
+
+    void setDecor(uint8_t tile, uint8_t decorID) {
+        auto it = std::lower_bound(decor.begin(), decor.end(), tile, [](const TileDecor& d, uint8_t t) { return d.tile < t; });
+        if (it != decor.end() && it->tile == tile) {
+            if (decorID == 0) decor.erase(it);
+            else it->decorID = decorID;
+        } else if (decorID != 0) {
+            decor.insert(it, {tile, decorID});
+        }
+    }
+};
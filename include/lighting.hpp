@@ -0,0 +1,314 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <SDL3/SDL.h>
+#include <JFLX/logging.hpp>
+
+#include "room.hpp"
+#include "player.hpp"
+
+/*
+++ Line of Sight / Lighting
+The field of view of the player is a square of LIGHT_FIELDSIZE tiles around the player tile,
+lit by recursive shadowcasting (8 octants) over the wall tiles and faded with the distance.
+
+- Main thread: keeps the walls of every chunk as bit rows (ChunkWallBits, rebuilt when Chunk::revision changes),
+  copies the walls of the field into a job when the player entered another tile or a chunk of the field changed
+- Worker thread: casts the light of the newest job, older jobs that were not started yet are dropped
+- Main thread: uploads a finished field as a LIGHT_FIELDSIZE² texture (one pixel per tile, linear filtered)
+  and draws it black with the darkness as alpha over the chunks
+
+Standing still costs one revision check per chunk of the field per frame, no job is sent.
+LIGHT_RADIUS 16 covers the 1920x1080 virtual screen when the camera is centered on the player.
+*/
+static constexpr int LIGHT_RADIUS    = 16;
+static constexpr int LIGHT_FIELDSIZE = LIGHT_RADIUS * 2 + 1;
+static constexpr uint8_t LIGHT_DARKNESS = 235;   // alpha of tiles the player can not see
+
+struct ChunkWallBits {
+    uint32_t revision = UINT32_MAX;
+    std::array<uint16_t, CHUNKSIZE> rows{};   // bit x of rows[y] = tiles[y][x].isWall
+};
+
+struct LightJob {
+    int originX = 0;   // global tile of field cell (0, 0)
+    int originY = 0;
+    std::vector<uint8_t> opaque;   // LIGHT_FIELDSIZE², 1 = wall
+};
+
+struct LightField {
+    int originX = 0;
+    int originY = 0;
+    std::vector<uint8_t> light;    // LIGHT_FIELDSIZE², 0 = dark, 255 = fully lit
+};
+
+/*
+++ Recursive Shadowcasting
+Lights one octant, row by row away from the center, slopes narrow where walls block the view.
+xx / xy / yx / yy map the octant onto the field.
+*/
+void castLight(const LightJob& job, LightField& field, int row, float start, float end, int xx, int xy, int yx, int yy) {
+    if (start < end) return;
+
+    const int center = LIGHT_RADIUS;
+    float newStart = 0.0f;
+
+    for (int j = row; j <= LIGHT_RADIUS; ++j) {
+        bool blocked = false;
+        for (int dx = -j, dy = -j; dx <= 0; ++dx) {
+            float leftSlope  = (dx - 0.5f) / (dy + 0.5f);
+            float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < rightSlope) continue;
+            if (end > leftSlope) break;
+
+            int fx = center + dx * xx + dy * xy;
+            int fy = center + dx * yx + dy * yy;
+            size_t index = size_t(fy) * LIGHT_FIELDSIZE + fx;
+
+            int distance2 = dx * dx + dy * dy;
+            if (distance2 <= LIGHT_RADIUS * LIGHT_RADIUS) {
+                float falloff = 1.0f - std::sqrt(float(distance2)) / float(LIGHT_RADIUS + 1);
+                field.light[index] = std::max(field.light[index], uint8_t(255.0f * falloff * falloff));
+            }
+
+            if (blocked) {
+                if (job.opaque[index]) {
+                    newStart = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                start = newStart;
+            } else if (job.opaque[index] && j < LIGHT_RADIUS) {
+                blocked = true;
+                castLight(job, field, j + 1, start, leftSlope, xx, xy, yx, yy);
+                newStart = rightSlope;
+            }
+        }
+        if (blocked) break;
+    }
+}
+
+void computeLightField(const LightJob& job, LightField& field) {
+    static constexpr int OCTANTS[8][4] = {
+        { 1,  0,  0,  1}, { 0,  1,  1,  0}, { 0, -1,  1,  0}, {-1,  0,  0,  1},
+        {-1,  0,  0, -1}, { 0, -1, -1,  0}, { 0,  1, -1,  0}, { 1,  0,  0, -1}
+    };
+
+    field.originX = job.originX;
+    field.originY = job.originY;
+    field.light.assign(size_t(LIGHT_FIELDSIZE) * LIGHT_FIELDSIZE, 0);
+    field.light[size_t(LIGHT_RADIUS) * LIGHT_FIELDSIZE + LIGHT_RADIUS] = 255;
+
+    for (const auto& o : OCTANTS) {
+        castLight(job, field, 1, 1.0f, 0.0f, o[0], o[1], o[2], o[3]);
+    }
+}
+
+class LightingSystem {
+public:
+    //++ Fields are cast on the main thread in update(), every frame shows the light of its own position (render benchmark)
+    bool synchronous = false;
+
+    LightingSystem() {
+        worker = std::thread([this]() { workerLoop(); });
+    }
+
+    ~LightingSystem() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeWorker.notify_all();
+        worker.join();
+    }
+
+    LightingSystem(const LightingSystem&) = delete;
+    LightingSystem& operator=(const LightingSystem&) = delete;
+
+    //++ Sends a new job when the player entered another tile or the walls around changed, uploads finished fields
+    void update(SDL_Renderer* renderer, ChunkManager& mgr, const Player& p) {
+        int playerTileX = worldToTile(p.x + p.width * 0.5f);
+        int playerTileY = worldToTile(p.y + p.height * 0.5f);
+        int originX = playerTileX - LIGHT_RADIUS;
+        int originY = playerTileY - LIGHT_RADIUS;
+
+        uint64_t key = fieldKey(mgr, originX, originY);
+        if (key != submittedKey) {
+            submittedKey = key;
+            submit(mgr, originX, originY);
+            if (synchronous) {
+                computeLightField(building, uploaded);
+                upload(renderer);
+                return;
+            }
+        }
+
+        bool hasResult = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (resultReady) {
+                std::swap(finished, uploaded);
+                resultReady = false;
+                hasResult = true;
+            }
+        }
+        if (hasResult) upload(renderer);
+    }
+
+    //++ Draws the darkness over the chunks, camera = world position of the top left screen corner
+    void render(RenderQueue& queue, float cameraX = 0.0f, float cameraY = 0.0f) const {
+        if (!texture) return;
+
+        //-> Pixel centers sit on tile centers, so the linear filter blends between neighbouring tiles
+        SDL_FRect dst {
+            float(uploaded.originX * TILESIZE) - cameraX,
+            float(uploaded.originY * TILESIZE) - cameraY,
+            float(LIGHT_FIELDSIZE * TILESIZE),
+            float(LIGHT_FIELDSIZE * TILESIZE)
+        };
+        queue.sprite(RENDERLAYER::LIGHT, texture, nullptr, dst);
+    }
+
+    void destroy() {
+        if (texture) {
+            SDL_DestroyTexture(texture);
+            texture = nullptr;
+        }
+    }
+
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeWorker;
+    bool stopping = false;
+
+    //++ Guarded by mutex
+    LightJob pending;
+    bool hasPending = false;
+    LightField finished;
+    bool resultReady = false;
+
+    //++ Main thread only
+    std::unordered_map<int64_t, ChunkWallBits> wallCache;
+    uint64_t submittedKey = 0;
+    LightJob building;
+    LightField uploaded;
+    std::vector<uint32_t> pixels;
+    SDL_Texture* texture = nullptr;
+
+    //++ Cached wall bits of a chunk, nullptr when the chunk is not loaded
+    const ChunkWallBits* wallBits(ChunkManager& mgr, int chunkX, int chunkY) {
+        Chunk* c = mgr.findChunk(chunkX, chunkY);
+        if (!c) return nullptr;
+
+        ChunkWallBits& bits = wallCache[mgr.chunkKey(chunkX, chunkY)];
+        if (bits.revision != c->revision) {
+            for (int y = 0; y < CHUNKSIZE; ++y) {
+                uint16_t row = 0;
+                for (int x = 0; x < CHUNKSIZE; ++x) {
+                    if (c->tiles[y][x].isWall) row |= uint16_t(1u << x);
+                }
+                bits.rows[y] = row;
+            }
+            bits.revision = c->revision;
+        }
+        return &bits;
+    }
+
+    //++ Changes when the field moves or a chunk of it is loaded / changed
+    uint64_t fieldKey(ChunkManager& mgr, int originX, int originY) {
+        uint64_t key = (uint64_t(uint32_t(originX)) << 32 | uint32_t(originY)) * 0x9E3779B97F4A7C15ull;
+        for (int cy = tileToChunk(originY); cy <= tileToChunk(originY + LIGHT_FIELDSIZE - 1); ++cy) {
+            for (int cx = tileToChunk(originX); cx <= tileToChunk(originX + LIGHT_FIELDSIZE - 1); ++cx) {
+                Chunk* c = mgr.findChunk(cx, cy);
+                key = (key ^ (c ? uint64_t(c->revision) + 1 : 0)) * 1099511628211ull;
+            }
+        }
+        return key | 1;   // 0 = nothing submitted yet
+    }
+
+    void submit(ChunkManager& mgr, int originX, int originY) {
+        building.originX = originX;
+        building.originY = originY;
+        building.opaque.assign(size_t(LIGHT_FIELDSIZE) * LIGHT_FIELDSIZE, 0);
+
+        //-> Copy the walls chunk by chunk, unloaded chunks are open
+        for (int cy = tileToChunk(originY); cy <= tileToChunk(originY + LIGHT_FIELDSIZE - 1); ++cy) {
+            for (int cx = tileToChunk(originX); cx <= tileToChunk(originX + LIGHT_FIELDSIZE - 1); ++cx) {
+                const ChunkWallBits* bits = wallBits(mgr, cx, cy);
+                if (!bits) continue;
+
+                int beginX = std::max(originX, cx * CHUNKSIZE), endX = std::min(originX + LIGHT_FIELDSIZE, (cx + 1) * CHUNKSIZE);
+                int beginY = std::max(originY, cy * CHUNKSIZE), endY = std::min(originY + LIGHT_FIELDSIZE, (cy + 1) * CHUNKSIZE);
+                for (int ty = beginY; ty < endY; ++ty) {
+                    uint16_t row = bits->rows[tileToLocal(ty)];
+                    uint8_t* out = building.opaque.data() + size_t(ty - originY) * LIGHT_FIELDSIZE;
+                    for (int tx = beginX; tx < endX; ++tx) {
+                        out[tx - originX] = (row >> tileToLocal(tx)) & 1;
+                    }
+                }
+            }
+        }
+        if (synchronous) return;   // cast by update()
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(pending, building);
+            hasPending = true;
+        }
+        wakeWorker.notify_one();
+    }
+
+    void upload(SDL_Renderer* renderer) {
+        if (!texture) {
+            texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, LIGHT_FIELDSIZE, LIGHT_FIELDSIZE);
+            if (!texture) {
+                JFLX::log("Lighting: ", std::string("Failed to create light texture ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                return;
+            }
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_LINEAR);
+        }
+
+        //-> RGBA32 is r, g, b, a in memory: black with the darkness as alpha
+        pixels.resize(uploaded.light.size());
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            uint8_t alpha = uint8_t(LIGHT_DARKNESS - (uint32_t(LIGHT_DARKNESS) * uploaded.light[i]) / 255);
+            uint8_t rgba[4] = {0, 0, 0, alpha};
+            std::memcpy(&pixels[i], rgba, sizeof(rgba));
+        }
+        SDL_UpdateTexture(texture, nullptr, pixels.data(), LIGHT_FIELDSIZE * 4);
+    }
+
+    void workerLoop() {
+        LightJob job;
+        LightField field;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeWorker.wait(lock, [this]() { return stopping || hasPending; });
+                if (stopping) return;
+                std::swap(job, pending);
+                hasPending = false;
+            }
+
+            computeLightField(job, field);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(finished, field);
+            resultReady = true;
+        }
+    }
+};
@@ -1,33 +1,217 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <cstddef>
+#include <array>
+#include <deque>
+#include <fstream>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+#include <JFLX/logging.hpp>
 
 //-> Objects Based on: https://backrooms-wiki.wikidot.com/objects
 enum class objectIDs : uint16_t {
     EMPTY,
     ALMONDWATER,
+    FLASHLIGHT,
 
     Count,
     UNKNOWN = UINT16_MAX
 };
 
-objectIDs getObjectID(std::string objectName) {
-    if (objectName == "EMPTY")          return objectIDs::EMPTY;
-    if (objectName == "Almond Water")   return objectIDs::ALMONDWATER;
+/*
+++ Built-in Object Names
+Every built-in object has its display name first, further entries are accepted aliases (old names, spellings in the level data).
+The names are found with a perfect hash that is searched at compile time, so a lookup hashes the name once and compares one string.
+*/
+struct BuiltinObjectName {
+    std::string_view name;
+    objectIDs id;
+};
+
+static constexpr BuiltinObjectName BUILTINOBJECTNAMES[] = {
+    {"Empty",        objectIDs::EMPTY},
+    {"EMPTY",        objectIDs::EMPTY},
+    {"Almond Water", objectIDs::ALMONDWATER},
+    {"FlashLight",   objectIDs::FLASHLIGHT},
+    {"Flashlight",   objectIDs::FLASHLIGHT},
+};
+
+//++ Display name of every built-in object, index = objectIDs
+static constexpr std::string_view BUILTINOBJECTDISPLAYNAMES[] = {
+    "Empty",
+    "Almond Water",
+    "FlashLight",
+};
+static_assert(std::size(BUILTINOBJECTDISPLAYNAMES) == size_t(objectIDs::Count), "BUILTINOBJECTDISPLAYNAMES needs a name for every objectIDs entry");
+
+constexpr uint32_t objectNameHash(std::string_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name) {
+        hash = (hash ^ uint8_t(c)) * 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+static constexpr size_t OBJECTHASHSIZE = 16;   // power of two, at least 2x the built-in names
+static constexpr uint8_t OBJECTHASHFREE = UINT8_MAX;
+static_assert(std::size(BUILTINOBJECTNAMES) * 2 <= OBJECTHASHSIZE, "Increase OBJECTHASHSIZE");
+
+//++ First seed that puts every built-in name into its own slot
+constexpr uint32_t findObjectHashSeed() {
+    for (uint32_t seed = 1; seed < 100000; ++seed) {
+        bool used[OBJECTHASHSIZE] = {};
+        bool collision = false;
+        for (const BuiltinObjectName& entry : BUILTINOBJECTNAMES) {
+            size_t slot = objectNameHash(entry.name, seed) & (OBJECTHASHSIZE - 1);
+            if (used[slot]) {
+                collision = true;
+                break;
+            }
+            used[slot] = true;
+        }
+        if (!collision) return seed;
+    }
+    return 0;
+}
+
+static constexpr uint32_t OBJECTHASHSEED = findObjectHashSeed();
+static_assert(OBJECTHASHSEED != 0, "No perfect hash seed found for the built-in object names");
 
+constexpr std::array<uint8_t, OBJECTHASHSIZE> buildObjectHashSlots() {
+    std::array<uint8_t, OBJECTHASHSIZE> slots{};
+    for (uint8_t& slot : slots) slot = OBJECTHASHFREE;
+    for (size_t i = 0; i < std::size(BUILTINOBJECTNAMES); ++i) {
+        slots[objectNameHash(BUILTINOBJECTNAMES[i].name, OBJECTHASHSEED) & (OBJECTHASHSIZE - 1)] = uint8_t(i);
+    }
+    return slots;
+}
+
+static constexpr std::array<uint8_t, OBJECTHASHSIZE> OBJECTHASHSLOTS = buildObjectHashSlots();
 
-    
-    // if (objectName == "")  return objectIDs::;
-    return objectIDs::UNKNOWN;
+constexpr objectIDs builtinObjectID(std::string_view name) {
+    uint8_t slot = OBJECTHASHSLOTS[objectNameHash(name, OBJECTHASHSEED) & (OBJECTHASHSIZE - 1)];
+    if (slot == OBJECTHASHFREE || BUILTINOBJECTNAMES[slot].name != name) return objectIDs::UNKNOWN;
+    return BUILTINOBJECTNAMES[slot].id;
 }
 
-std::string getObjectName(uint16_t objectID) {
-    if (objectID == static_cast<uint16_t>(objectIDs::EMPTY)) return "Empty";
-    if (objectID == static_cast<uint16_t>(objectIDs::ALMONDWATER)) return "Almond Water";
+static_assert(builtinObjectID("Almond Water") == objectIDs::ALMONDWATER);
+static_assert(builtinObjectID("Almond") == objectIDs::UNKNOWN);
+
+/*
+++ Object Registry
+Every object (built-in or added in gameData/json/objects.jsonc) by ID: name, texture and the free form properties of the json.
+IDs are dense (built-ins first, json objects after them), so ID -> object is an index.
+Name -> ID tries the compile time hash of the built-ins first and the map of json names after it.
+
+Returned names / objects stay valid until the next load(), names of built-ins stay valid forever.
+*/
+struct ObjectInfo {
+    uint16_t id = 0;
+    std::string_view name;
+    std::string texture;
+    int stackSize = 1;
+    nlohmann::json properties;
+};
+
+class ObjectRegistry {
+public:
+    ObjectRegistry() {
+        resetBuiltins();
+    }
+
+    bool load(const std::string& objectsPath) {
+        std::ifstream file(objectsPath);
+        if (!file.is_open()) {
+            JFLX::log("Object Registry: ", "Failed to open " + objectsPath, JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+
+        try {
+            nlohmann::json data = nlohmann::json::parse(file, nullptr, true, true); //-> allow comments (.jsonc)
+            resetBuiltins();
+
+            nlohmann::json objectData = data.at("objects");
+            for (const auto& [name, entry] : objectData.items()) {
+                ObjectInfo* object = nullptr;
+                objectIDs builtin = builtinObjectID(name);
+                if (builtin != objectIDs::UNKNOWN) {
+                    object = &objects[size_t(builtin)];
+                } else if (byName.find(std::string_view(name)) != byName.end()) {
+                    JFLX::log("Object Registry: ", "Duplicate object " + name, JFLX::LOGTYPE::WARNING);
+                    continue;
+                } else if (objects.size() >= size_t(objectIDs::UNKNOWN)) {
+                    JFLX::log("Object Registry: ", "Too many objects, skipping " + name, JFLX::LOGTYPE::WARNING);
+                    continue;
+                } else {
+                    const std::string& stored = names.emplace_back(name);
+                    object = &objects.emplace_back();
+                    object->id   = uint16_t(objects.size() - 1);
+                    object->name = stored;
+                    byName.emplace(std::string_view(stored), object->id);
+                }
+
+                object->texture    = entry.value("texture", "");
+                object->stackSize  = entry.value("stackSize", 1);
+                object->properties = entry.value("properties", nlohmann::json::object());
+            }
+        } catch (const std::exception& e) {
+            JFLX::log("Object Registry: ", "Invalid objects in " + objectsPath + ": " + e.what(), JFLX::LOGTYPE::ERROR);
+            resetBuiltins();
+            return false;
+        }
+
+        JFLX::log("Object Registry: ", "Loaded " + std::to_string(objects.size()) + " objects", JFLX::LOGTYPE::SUCCESS);
+        return true;
+    }
+
+    uint16_t id(std::string_view name) const {
+        objectIDs builtin = builtinObjectID(name);
+        if (builtin != objectIDs::UNKNOWN) return uint16_t(builtin);
 
+        auto it = byName.find(name);
+        return it != byName.end() ? it->second : uint16_t(objectIDs::UNKNOWN);
+    }
 
+    //++ nullptr for unknown IDs
+    const ObjectInfo* get(uint16_t objectID) const {
+        return objectID < objects.size() ? &objects[objectID] : nullptr;
+    }
+
+    std::string_view name(uint16_t objectID) const {
+        return objectID < objects.size() ? objects[objectID].name : std::string_view("Unknown");
+    }
+
+    size_t size() const {
+        return objects.size();
+    }
+
+private:
+    std::deque<ObjectInfo> objects;   // deque: growing never moves the objects
+    std::deque<std::string> names;    // storage of the json names the string_views point to
+    std::unordered_map<std::string_view, uint16_t> byName;   // keys point into names, find() builds no std::string
+
+    void resetBuiltins() {
+        objects.clear();
+        names.clear();
+        byName.clear();
+        for (size_t i = 0; i < size_t(objectIDs::Count); ++i) {
+            ObjectInfo& object = objects.emplace_back();
+            object.id   = uint16_t(i);
+            object.name = BUILTINOBJECTDISPLAYNAMES[i];
+        }
+    }
+};
+
+inline ObjectRegistry objectRegistry;
+
+inline objectIDs getObjectID(std::string_view objectName) {
+    return objectIDs(objectRegistry.id(objectName));
+}
 
-    // if (objectID == static_cast<uint16_t>(objectIDs::)) return "";
-    return "Unknown";
+inline std::string_view getObjectName(uint16_t objectID) {
+    return objectRegistry.name(objectID);
 }
@@ -0,0 +1,503 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <array>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include "room.hpp"
+
+/*
+++ Hierarchical Pathfinding (HPA*)
+Every loaded chunk gets a ChunkNav: its walls as bit rows, portal nodes on its borders and the walking distance between every two nodes of the chunk.
+A portal is placed on every run of border tiles that are open on both sides of the border (runs of 6+ tiles get one at each end),
+so the node on the other side of a portal is always the neighbouring tile.
+
+A query links start and goal to the nodes of their chunks (BFS inside the chunk), runs A* over the nodes
+and refines every step into tiles with a BFS inside one chunk. Unloaded chunks are not walkable.
+
+- Repair: PathService::update compares Chunk::revision, a changed chunk and its 4 neighbours (their border portals depend on it) are rebuilt,
+  navs of unloaded chunks are dropped
+- Requests: queued per owner (a newer request of the same owner replaces the pending one), served by worker threads,
+  the results are collected on the main thread with poll()
+- The navs are published as an immutable NavGraph: a query keeps the graph it started on (shared_ptr), a repair builds
+  the rebuilt chunks into a new graph (unchanged navs are shared) and swaps it in, so neither ever waits on the other
+*/
+static constexpr int PATH_MAXEXPANSIONS = 8192;   // abstract nodes per query, more = no path
+static constexpr uint16_t PATH_UNREACHABLE = UINT16_MAX;
+
+struct NavNode {
+    uint8_t x = 0, y = 0;       // chunk local tile
+    int8_t dirX = 0, dirY = 0;  // direction of the border it sits on, the tile across is the partner node
+};
+
+struct ChunkNav {
+    uint32_t revision = UINT32_MAX;
+    std::array<uint16_t, CHUNKSIZE> walls{};   // bit x of walls[y] = tiles[y][x].isWall
+    std::vector<NavNode> nodes;
+    std::vector<uint16_t> distances;           // nodes² walking distances, PATH_UNREACHABLE = not connected
+
+    bool isWall(int x, int y) const {
+        return (walls[y] >> x) & 1;
+    }
+};
+
+/*
+++ BFS inside one chunk, distance[local index] from (x, y), PATH_UNREACHABLE for walls / unreached tiles
+parent (optional) receives the local index of the tile a tile was reached from
+*/
+void chunkDistances(const ChunkNav& nav, int x, int y, std::array<uint16_t, CHUNKSIZE * CHUNKSIZE>& distance, std::array<uint16_t, CHUNKSIZE * CHUNKSIZE>* parent = nullptr) {
+    distance.fill(PATH_UNREACHABLE);
+    if (nav.isWall(x, y)) return;
+
+    std::array<uint16_t, CHUNKSIZE * CHUNKSIZE> queue;
+    size_t head = 0, tail = 0;
+    distance[y * CHUNKSIZE + x] = 0;
+    queue[tail++] = uint16_t(y * CHUNKSIZE + x);
+
+    static constexpr int STEPS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    while (head < tail) {
+        int current = queue[head++];
+        int cx = current % CHUNKSIZE, cy = current / CHUNKSIZE;
+        for (const auto& step : STEPS) {
+            int nx = cx + step[0], ny = cy + step[1];
+            if (nx < 0 || ny < 0 || nx >= CHUNKSIZE || ny >= CHUNKSIZE || nav.isWall(nx, ny)) continue;
+
+            int next = ny * CHUNKSIZE + nx;
+            if (distance[next] != PATH_UNREACHABLE) continue;
+            distance[next] = uint16_t(distance[current] + 1);
+            if (parent) (*parent)[next] = uint16_t(current);
+            queue[tail++] = uint16_t(next);
+        }
+    }
+}
+
+//++ Appends the tiles after (fromX, fromY) up to (toX, toY) inside one chunk as global tiles, false when not connected
+bool chunkPath(const ChunkNav& nav, int chunkX, int chunkY, int fromX, int fromY, int toX, int toY, std::vector<std::array<int, 2>>& out) {
+    std::array<uint16_t, CHUNKSIZE * CHUNKSIZE> distance, parent;
+    chunkDistances(nav, toX, toY, distance, &parent);
+    if (distance[fromY * CHUNKSIZE + fromX] == PATH_UNREACHABLE) return false;
+
+    //-> The BFS ran from the target, so following parents from the start walks towards it
+    int current = fromY * CHUNKSIZE + fromX;
+    int target  = toY * CHUNKSIZE + toX;
+    while (current != target) {
+        current = parent[current];
+        out.push_back({chunkX * CHUNKSIZE + current % CHUNKSIZE, chunkY * CHUNKSIZE + current / CHUNKSIZE});
+    }
+    return true;
+}
+
+struct PathRequest {
+    uint32_t owner = 0;        // e.g. entity id, one pending request per owner
+    uint32_t generation = 0;   // handed back with the result
+    int startX = 0, startY = 0;
+    int goalX = 0, goalY = 0;  // global tiles
+};
+
+struct PathResult {
+    uint32_t owner = 0;
+    uint32_t generation = 0;
+    bool found = false;
+    std::vector<std::array<int, 2>> tiles;   // global tiles after the start up to the goal
+};
+
+class PathService {
+public:
+    //++ Requests are answered on the calling thread, results only depend on the requests (replays, inputRecording.hpp)
+    bool synchronous = false;
+
+    explicit PathService(unsigned threadCount = std::max(1u, std::thread::hardware_concurrency() / 2)) {
+        threadCount = std::max(1u, threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            threads.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~PathService() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        wakeWorkers.notify_all();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    PathService(const PathService&) = delete;
+    PathService& operator=(const PathService&) = delete;
+
+    //++ Rebuilds the nav of changed chunks (and their neighbours) into a new graph and publishes it, main thread
+    void update(ChunkManager& mgr) {
+        //-> Only the main thread publishes graphs, reading the current one here needs no lock
+        const NavGraph& current = *graph;
+        std::vector<int64_t> changed;
+        for (auto& [key, chunk] : mgr.chunks) {
+            auto it = current.navs.find(int64_t(key));
+            if (it == current.navs.end() || it->second->revision != chunk.revision) changed.push_back(int64_t(key));
+        }
+        std::vector<int64_t> removed;
+        for (const auto& [key, nav] : current.navs) {
+            if (mgr.chunks.find(uint64_t(key)) == mgr.chunks.end()) removed.push_back(key);
+        }
+        if (changed.empty() && removed.empty()) return;
+
+        std::shared_ptr<NavGraph> next = std::make_shared<NavGraph>(current);
+        std::unordered_map<int64_t, std::shared_ptr<ChunkNav>> rebuilt;
+        std::unordered_set<int64_t> rebuild;
+        for (int64_t key : removed) {
+            next->navs.erase(key);
+            for (int64_t neighbour : neighbourKeys(key)) rebuild.insert(neighbour);
+        }
+        for (int64_t key : changed) {
+            Chunk& chunk = mgr.chunks.at(uint64_t(key));
+            std::shared_ptr<ChunkNav> fresh = std::make_shared<ChunkNav>();
+            ChunkNav& nav = *fresh;
+            for (int y = 0; y < CHUNKSIZE; ++y) {
+                uint16_t row = 0;
+                for (int x = 0; x < CHUNKSIZE; ++x) {
+                    if (chunk.tiles[y][x].isWall) row |= uint16_t(1u << x);
+                }
+                nav.walls[y] = row;
+            }
+            nav.revision = chunk.revision;
+            next->navs[key] = fresh;
+            rebuilt[key]    = fresh;
+
+            rebuild.insert(key);
+            for (int64_t neighbour : neighbourKeys(key)) rebuild.insert(neighbour);
+        }
+
+        //-> Navs of the old graph are never changed (a query may still read them), a neighbour is rebuilt on a copy
+        for (int64_t key : rebuild) {
+            auto it = next->navs.find(key);
+            if (it == next->navs.end()) continue;
+            auto fresh = rebuilt.find(key);
+            std::shared_ptr<ChunkNav> nav = fresh != rebuilt.end() ? fresh->second : std::make_shared<ChunkNav>(*it->second);
+            buildPortals(*next, key, *nav);
+            it->second = nav;
+        }
+
+        //-> The old graph is released after the lock (or by the last query that still uses it)
+        std::shared_ptr<const NavGraph> published = std::move(next);
+        std::lock_guard<std::mutex> lock(graphMutex);
+        graph.swap(published);
+    }
+
+    void request(const PathRequest& pathRequest) {
+        if (synchronous) {
+            PathResult result;
+            result.owner      = pathRequest.owner;
+            result.generation = pathRequest.generation;
+            result.found      = findPath(pathRequest.startX, pathRequest.startY, pathRequest.goalX, pathRequest.goalY, result.tiles);
+
+            std::lock_guard<std::mutex> lock(queueMutex);
+            finished.push_back(std::move(result));
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            auto [it, inserted] = pending.insert_or_assign(pathRequest.owner, pathRequest);
+            if (inserted) order.push_back(pathRequest.owner);
+        }
+        wakeWorkers.notify_one();
+    }
+
+    //++ Moves every finished result into out
+    void poll(std::vector<PathResult>& out) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (PathResult& result : finished) {
+            out.push_back(std::move(result));
+        }
+        finished.clear();
+    }
+
+    //++ Synchronous query, also used by the workers
+    bool findPath(int startX, int startY, int goalX, int goalY, std::vector<std::array<int, 2>>& out) const {
+        std::shared_ptr<const NavGraph> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(graphMutex);
+            snapshot = graph;
+        }
+        return search(*snapshot, startX, startY, goalX, goalY, out);
+    }
+
+private:
+    struct NavGraph {
+        std::unordered_map<int64_t, std::shared_ptr<const ChunkNav>> navs;
+
+        const ChunkNav* navOf(int chunkX, int chunkY) const {
+            auto it = navs.find(packChunk(chunkX, chunkY));
+            return it != navs.end() ? it->second.get() : nullptr;
+        }
+    };
+
+    //++ Only the main thread replaces the graph, graphMutex is held just to copy / swap the pointer
+    std::shared_ptr<const NavGraph> graph = std::make_shared<NavGraph>();
+    mutable std::mutex graphMutex;
+
+    std::vector<std::thread> threads;
+    std::mutex queueMutex;
+    std::condition_variable wakeWorkers;
+    std::unordered_map<uint32_t, PathRequest> pending;
+    std::deque<uint32_t> order;
+    std::vector<PathResult> finished;
+    bool stopping = false;
+
+    static int64_t packChunk(int chunkX, int chunkY) {
+        return (int64_t(chunkX) << 32) | uint32_t(chunkY);
+    }
+
+    static int chunkXOf(int64_t key) { return int(key >> 32); }
+    static int chunkYOf(int64_t key) { return int(uint32_t(key)); }
+
+    static std::array<int64_t, 4> neighbourKeys(int64_t key) {
+        int cx = chunkXOf(key), cy = chunkYOf(key);
+        return {packChunk(cx + 1, cy), packChunk(cx - 1, cy), packChunk(cx, cy + 1), packChunk(cx, cy - 1)};
+    }
+
+    //++ Portals of all 4 borders and the distances between them, the neighbours are taken from graph
+    static void buildPortals(const NavGraph& graph, int64_t key, ChunkNav& nav) {
+        int cx = chunkXOf(key), cy = chunkYOf(key);
+        nav.nodes.clear();
+
+        struct Border {
+            int dirX, dirY;
+        };
+        static constexpr Border BORDERS[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+        for (const Border& border : BORDERS) {
+            const ChunkNav* other = graph.navOf(cx + border.dirX, cy + border.dirY);
+            if (!other) continue;
+
+            //-> Tile i of the border, own side and the side across
+            auto ownTile = [&](int i) -> std::array<int, 2> {
+                if (border.dirX != 0) return {border.dirX > 0 ? CHUNKSIZE - 1 : 0, i};
+                return {i, border.dirY > 0 ? CHUNKSIZE - 1 : 0};
+            };
+            auto open = [&](int i) {
+                std::array<int, 2> own = ownTile(i);
+                int ox = (own[0] + border.dirX + CHUNKSIZE) % CHUNKSIZE;
+                int oy = (own[1] + border.dirY + CHUNKSIZE) % CHUNKSIZE;
+                return !nav.isWall(own[0], own[1]) && !other->isWall(ox, oy);
+            };
+            auto addNode = [&](int i) {
+                std::array<int, 2> own = ownTile(i);
+                nav.nodes.push_back({uint8_t(own[0]), uint8_t(own[1]), int8_t(border.dirX), int8_t(border.dirY)});
+            };
+
+            for (int i = 0; i < CHUNKSIZE; ) {
+                if (!open(i)) {
+                    ++i;
+                    continue;
+                }
+                int runStart = i;
+                while (i < CHUNKSIZE && open(i)) ++i;
+                int runEnd = i - 1;
+
+                if (runEnd - runStart + 1 >= 6) {
+                    addNode(runStart);
+                    addNode(runEnd);
+                } else {
+                    addNode((runStart + runEnd) / 2);
+                }
+            }
+        }
+
+        size_t count = nav.nodes.size();
+        nav.distances.assign(count * count, PATH_UNREACHABLE);
+        std::array<uint16_t, CHUNKSIZE * CHUNKSIZE> distance;
+        for (size_t a = 0; a < count; ++a) {
+            chunkDistances(nav, nav.nodes[a].x, nav.nodes[a].y, distance);
+            for (size_t b = 0; b < count; ++b) {
+                nav.distances[a * count + b] = distance[nav.nodes[b].y * CHUNKSIZE + nav.nodes[b].x];
+            }
+        }
+    }
+
+    struct NodeKey {
+        int64_t chunk;
+        uint32_t node;   // GOALNODE / STARTNODE for the query ends
+
+        bool operator==(const NodeKey& other) const {
+            return chunk == other.chunk && node == other.node;
+        }
+    };
+
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const {
+            return std::hash<int64_t>()(key.chunk) ^ (size_t(key.node) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    static constexpr uint32_t STARTNODE = UINT32_MAX - 1;
+    static constexpr uint32_t GOALNODE  = UINT32_MAX;
+
+    static bool search(const NavGraph& graph, int startX, int startY, int goalX, int goalY, std::vector<std::array<int, 2>>& out) {
+        out.clear();
+        int startChunkX = tileToChunk(startX), startChunkY = tileToChunk(startY);
+        int goalChunkX  = tileToChunk(goalX),  goalChunkY  = tileToChunk(goalY);
+        const ChunkNav* startNav = graph.navOf(startChunkX, startChunkY);
+        const ChunkNav* goalNav  = graph.navOf(goalChunkX, goalChunkY);
+        if (!startNav || !goalNav) return false;
+
+        int64_t startChunk = packChunk(startChunkX, startChunkY);
+        int64_t goalChunk  = packChunk(goalChunkX, goalChunkY);
+        int slx = tileToLocal(startX), sly = tileToLocal(startY);
+        int glx = tileToLocal(goalX),  gly = tileToLocal(goalY);
+        if (startNav->isWall(slx, sly) || goalNav->isWall(glx, gly)) return false;
+
+        std::array<uint16_t, CHUNKSIZE * CHUNKSIZE> fromStart, toGoal;
+        chunkDistances(*startNav, slx, sly, fromStart);
+        chunkDistances(*goalNav, glx, gly, toGoal);
+
+        struct Open {
+            int f, g;
+            NodeKey key;
+            bool operator>(const Open& other) const { return f > other.f; }
+        };
+        std::priority_queue<Open, std::vector<Open>, std::greater<Open>> open;
+        std::unordered_map<NodeKey, int, NodeKeyHash> best;
+        std::unordered_map<NodeKey, NodeKey, NodeKeyHash> cameFrom;
+
+        auto heuristic = [&](int64_t chunk, const NavNode& node) {
+            int x = chunkXOf(chunk) * CHUNKSIZE + node.x;
+            int y = chunkYOf(chunk) * CHUNKSIZE + node.y;
+            return std::abs(x - goalX) + std::abs(y - goalY);
+        };
+        auto push = [&](const NodeKey& key, const NodeKey& from, int g, int h) {
+            auto it = best.find(key);
+            if (it != best.end() && it->second <= g) return;
+            best[key] = g;
+            cameFrom[key] = from;
+            open.push({g + h, g, key});
+        };
+
+        NodeKey startKey = {startChunk, STARTNODE};
+        NodeKey goalKey  = {goalChunk, GOALNODE};
+
+        //-> Start and goal in one chunk and connected inside it
+        if (startChunk == goalChunk && fromStart[gly * CHUNKSIZE + glx] != PATH_UNREACHABLE) {
+            push(goalKey, startKey, fromStart[gly * CHUNKSIZE + glx], 0);
+        }
+        for (size_t n = 0; n < startNav->nodes.size(); ++n) {
+            const NavNode& node = startNav->nodes[n];
+            uint16_t d = fromStart[node.y * CHUNKSIZE + node.x];
+            if (d != PATH_UNREACHABLE) push({startChunk, uint32_t(n)}, startKey, d, heuristic(startChunk, node));
+        }
+
+        int expansions = 0;
+        bool found = false;
+        while (!open.empty() && expansions < PATH_MAXEXPANSIONS) {
+            Open current = open.top();
+            open.pop();
+            if (best[current.key] < current.g) continue;
+            if (current.key == goalKey) {
+                found = true;
+                break;
+            }
+            ++expansions;
+
+            const ChunkNav* nav = graph.navOf(chunkXOf(current.key.chunk), chunkYOf(current.key.chunk));
+            const NavNode& node = nav->nodes[current.key.node];
+            size_t count = nav->nodes.size();
+
+            //++ Inside the chunk
+            for (size_t n = 0; n < count; ++n) {
+                uint16_t d = nav->distances[current.key.node * count + n];
+                if (n == current.key.node || d == PATH_UNREACHABLE) continue;
+                push({current.key.chunk, uint32_t(n)}, current.key, current.g + d, heuristic(current.key.chunk, nav->nodes[n]));
+            }
+            if (current.key.chunk == goalChunk) {
+                uint16_t d = toGoal[node.y * CHUNKSIZE + node.x];
+                if (d != PATH_UNREACHABLE) push(goalKey, current.key, current.g + d, 0);
+            }
+
+            //++ Across the border, the partner sits on the opposite border of the neighbour
+            int otherChunkX = chunkXOf(current.key.chunk) + node.dirX;
+            int otherChunkY = chunkYOf(current.key.chunk) + node.dirY;
+            const ChunkNav* other = graph.navOf(otherChunkX, otherChunkY);
+            if (!other) continue;
+
+            int partnerX = (node.x + node.dirX + CHUNKSIZE) % CHUNKSIZE;
+            int partnerY = (node.y + node.dirY + CHUNKSIZE) % CHUNKSIZE;
+            for (size_t n = 0; n < other->nodes.size(); ++n) {
+                const NavNode& partner = other->nodes[n];
+                if (partner.x == partnerX && partner.y == partnerY && partner.dirX == -node.dirX && partner.dirY == -node.dirY) {
+                    int64_t otherChunk = packChunk(otherChunkX, otherChunkY);
+                    push({otherChunk, uint32_t(n)}, current.key, current.g + 1, heuristic(otherChunk, partner));
+                    break;
+                }
+            }
+        }
+        if (!found) return false;
+
+        //++ Abstract path back to front, then refined into tiles chunk by chunk
+        std::vector<NodeKey> abstract;
+        for (NodeKey key = goalKey; !(key == startKey); key = cameFrom.at(key)) {
+            abstract.push_back(key);
+        }
+        std::reverse(abstract.begin(), abstract.end());
+
+        int64_t chunk = startChunk;
+        int x = slx, y = sly;
+        for (const NodeKey& key : abstract) {
+            int targetX, targetY;
+            if (key.node == GOALNODE) {
+                targetX = glx;
+                targetY = gly;
+            } else {
+                const NavNode& node = graph.navOf(chunkXOf(key.chunk), chunkYOf(key.chunk))->nodes[key.node];
+                targetX = node.x;
+                targetY = node.y;
+            }
+
+            if (key.chunk != chunk) {
+                //-> Border crossing, the partner tile is the next step
+                chunk = key.chunk;
+                out.push_back({chunkXOf(chunk) * CHUNKSIZE + targetX, chunkYOf(chunk) * CHUNKSIZE + targetY});
+            } else if (!chunkPath(*graph.navOf(chunkXOf(chunk), chunkYOf(chunk)), chunkXOf(chunk), chunkYOf(chunk), x, y, targetX, targetY, out)) {
+                out.clear();
+                return false;
+            }
+            x = targetX;
+            y = targetY;
+        }
+        return true;
+    }
+
+    void workerLoop() {
+        while (true) {
+            PathRequest job;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                wakeWorkers.wait(lock, [this]() { return stopping || !order.empty(); });
+                if (stopping) return;
+                uint32_t owner = order.front();
+                order.pop_front();
+                job = pending.at(owner);
+                pending.erase(owner);
+            }
+
+            PathResult result;
+            result.owner      = job.owner;
+            result.generation = job.generation;
+            result.found      = findPath(job.startX, job.startY, job.goalX, job.goalY, result.tiles);
+
+            std::lock_guard<std::mutex> lock(queueMutex);
+            finished.push_back(std::move(result));
+        }
+    }
+};
@@ -16,6 +16,9 @@ struct Player {
     float width  = 64.0f;
     float height = 64.0f;
 
+    // Walking speed in pixels per second
+    float speed = 320.0f;
+
     // Inventory (object IDs)
     std::array<objectIDs, 10> inventory = {objectIDs::EMPTY};
 };
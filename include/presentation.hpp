@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+#include <SDL3/SDL.h>
+#include <JFLX/logging.hpp>
+
+/*
+++ Presentation
+The game draws in a fixed virtual space of PRESENT_VIRTUALWIDTH x PRESENT_VIRTUALHEIGHT, the frame is rendered into a texture
+sized from the window instead of always 1920x1080:
+
+- baseScale    = window fit scale (<= 1) * render quality (settings "renderQuality", 0.25 .. 1)
+                 -> a 960x540 window renders 960x540 pixels, not 1920x1080 scaled down
+- dynamicScale = dynamic resolution (settings "dynamicResolution"), lowered when frames are slower than the target,
+                 raised again when they are fast for a while (PRESENT_DYNSTEP steps, PRESENT_DYNMIN .. 1)
+- renderScale  = baseScale * dynamicScale, virtual -> texture pixels (RenderQueue::flush scale)
+
+The texture is allocated for baseScale, the dynamic scale only renders into its top left part (frame()), so holding
+the frame time never reallocates. The frame is shown centered with its aspect ratio kept (letterbox).
+*/
+static constexpr int PRESENT_VIRTUALWIDTH   = 1920;
+static constexpr int PRESENT_VIRTUALHEIGHT  = 1080;
+static constexpr float PRESENT_MINQUALITY   = 0.25f;
+static constexpr float PRESENT_DYNMIN       = 0.5f;
+static constexpr float PRESENT_DYNSTEP      = 0.1f;
+static constexpr float PRESENT_DYNSLOW      = 1.2f;    // average frame > target * SLOW -> lower
+static constexpr float PRESENT_DYNFAST      = 1.05f;   // average frame < target * FAST ...
+static constexpr float PRESENT_DYNRAISEWAIT = 2.0f;    // ... for this many seconds -> raise
+static constexpr float PRESENT_DYNDROPWAIT  = 0.5f;    // seconds between two drops
+
+class Presentation {
+public:
+    SDL_Texture* target = nullptr;
+    float quality       = 1.0f;
+    bool dynamicResolution = true;
+    float targetFrameMs = 1000.0f / 60.0f;
+
+    /*
+    ++ Fits the frame to the current window, call it every frame (only changes something when the size changed)
+    Returns false when the render texture could not be created
+    */
+    bool resize(SDL_Renderer* renderer, SDL_Window* window) {
+        int outputW = 0, outputH = 0, windowW = 0, windowH = 0;
+        SDL_GetRenderOutputSize(renderer, &outputW, &outputH);
+        SDL_GetWindowSize(window, &windowW, &windowH);
+        if (outputW <= 0 || outputH <= 0) return target != nullptr;   // minimized
+
+        if (target && outputW == outputWidth && outputH == outputHeight && quality == appliedQuality) return true;
+
+        outputWidth    = outputW;
+        outputHeight   = outputH;
+        pixelDensity   = windowW > 0 ? float(outputW) / float(windowW) : 1.0f;
+        appliedQuality = quality = std::clamp(quality, PRESENT_MINQUALITY, 1.0f);
+
+        //-> Letterbox: largest 16:9 rectangle of the output
+        float fit = std::min(float(outputW) / PRESENT_VIRTUALWIDTH, float(outputH) / PRESENT_VIRTUALHEIGHT);
+        viewport.w = PRESENT_VIRTUALWIDTH * fit;
+        viewport.h = PRESENT_VIRTUALHEIGHT * fit;
+        viewport.x = std::floor((outputW - viewport.w) / 2.0f);
+        viewport.y = std::floor((outputH - viewport.h) / 2.0f);
+
+        baseScale = std::min(fit, 1.0f) * quality;
+        int textureW = std::max(1, int(std::ceil(PRESENT_VIRTUALWIDTH * baseScale)));
+        int textureH = std::max(1, int(std::ceil(PRESENT_VIRTUALHEIGHT * baseScale)));
+
+        if (!target || textureW != targetWidth || textureH != targetHeight) {
+            if (target) SDL_DestroyTexture(target);
+            target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, textureW, textureH);
+            if (!target) {
+                JFLX::log("Presentation: ", std::string("SDL_CreateTexture failed: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                return false;
+            }
+            targetWidth  = textureW;
+            targetHeight = textureH;
+            JFLX::log("Presentation: ", "Rendering at " + std::to_string(textureW) + "x" + std::to_string(textureH) + " for " + std::to_string(outputW) + "x" + std::to_string(outputH), JFLX::LOGTYPE::INFO);
+        }
+        return true;
+    }
+
+    //++ Frame time of the last frame, adjusts the dynamic scale
+    void frameTime(float milliseconds) {
+        if (!dynamicResolution) {
+            dynamicScale = 1.0f;
+            return;
+        }
+
+        float seconds = milliseconds / 1000.0f;
+        averageMs = averageMs <= 0.0f ? milliseconds : averageMs * 0.9f + milliseconds * 0.1f;
+        sinceChange += seconds;
+
+        if (averageMs > targetFrameMs * PRESENT_DYNSLOW) {
+            fastFor = 0.0f;
+            if (sinceChange >= PRESENT_DYNDROPWAIT && dynamicScale > PRESENT_DYNMIN) {
+                setDynamicScale(dynamicScale - PRESENT_DYNSTEP);
+            }
+        } else if (averageMs < targetFrameMs * PRESENT_DYNFAST) {
+            fastFor += seconds;
+            //-> Raising right after a drop would bounce between two steps
+            if (fastFor >= PRESENT_DYNRAISEWAIT && dynamicScale < 1.0f) {
+                setDynamicScale(dynamicScale + PRESENT_DYNSTEP);
+                fastFor = 0.0f;
+            }
+        } else {
+            fastFor = 0.0f;
+        }
+    }
+
+    //++ Virtual -> render texture pixels of this frame
+    float renderScale() const {
+        return baseScale * dynamicScale;
+    }
+
+    //++ Part of the texture the frame is rendered into
+    SDL_FRect frame() const {
+        return {0.0f, 0.0f, PRESENT_VIRTUALWIDTH * renderScale(), PRESENT_VIRTUALHEIGHT * renderScale()};
+    }
+
+    //++ Window coordinates (mouse events) -> virtual coordinates
+    SDL_FPoint windowToVirtual(float x, float y) const {
+        if (viewport.w <= 0.0f || viewport.h <= 0.0f) return {x, y};
+        return {
+            (x * pixelDensity - viewport.x) * PRESENT_VIRTUALWIDTH / viewport.w,
+            (y * pixelDensity - viewport.y) * PRESENT_VIRTUALHEIGHT / viewport.h
+        };
+    }
+
+    //++ Shows the frame in the window, the letterbox is cleared black
+    void present(SDL_Renderer* renderer) const {
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        SDL_FRect src = frame();
+        SDL_RenderTexture(renderer, target, &src, &viewport);
+    }
+
+    void destroy() {
+        if (target) {
+            SDL_DestroyTexture(target);
+            target = nullptr;
+        }
+    }
+
+private:
+    int outputWidth  = 0;
+    int outputHeight = 0;
+    int targetWidth  = 0;
+    int targetHeight = 0;
+    float pixelDensity   = 1.0f;
+    float appliedQuality = 0.0f;
+    float baseScale      = 1.0f;
+    float dynamicScale   = 1.0f;
+    SDL_FRect viewport   = {0, 0, 0, 0};
+
+    float averageMs   = 0.0f;
+    float sinceChange = 0.0f;
+    float fastFor     = 0.0f;
+
+    void setDynamicScale(float scale) {
+        dynamicScale = std::clamp(scale, PRESENT_DYNMIN, 1.0f);
+        sinceChange  = 0.0f;
+    }
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL3_image/SDL_image.h>
+#include <JFLX/logging.hpp>
+
+#include "room.hpp"
+#include "renderQueue.hpp"
+#include "generationNoise.hpp"
+
+/*
+++ Render Benchmark
+Renders a scripted camera path through a generated world for a fixed number of frames, without input or a player,
+so the chunk rendering can be measured on machines without a GPU (--headless: software renderer):
+
+- The camera flies a figure eight of BENCH_PATHWIDTH x BENCH_PATHHEIGHT chunks, one BENCH_STEP of the path per frame
+  (the same frames on every machine, independent of the frame time)
+- Chunks get walls from the seed (benchmarkChunk), chunks around the view are loaded, the rest is unloaded,
+  so the path keeps rebuilding chunk textures like exploring does
+- Reported: chunk textures rebuilt, loaded chunks, draw calls / commands per frame (RenderQueue::lastFrame),
+  texture memory and the frame time percentiles (frameProfiler.hpp)
+- Selected frames can be saved as PNG for golden image comparisons
+*/
+static constexpr float BENCH_STEP         = 1.0f / 60.0f;   // seconds of the camera path per frame
+static constexpr float BENCH_PERIOD       = 40.0f;          // seconds for the whole figure eight
+static constexpr float BENCH_PATHWIDTH    = 6.0f;           // chunks
+static constexpr float BENCH_PATHHEIGHT   = 4.0f;           // chunks
+static constexpr int BENCH_KEEPCHUNKS     = 1;              // chunks loaded around the view
+static constexpr int BENCH_WALLSMOOTHNESS = 12;
+static constexpr uint8_t BENCH_WALLLEVEL  = 165;            // noise above this is a wall
+
+//++ World position of the camera center at seconds of the path
+inline SDL_FPoint benchmarkCamera(float seconds) {
+    float angle = seconds / BENCH_PERIOD * 6.2831853f;
+    return {
+        std::sin(angle) * BENCH_PATHWIDTH * 0.5f * CHUNKPIXELSIZE,
+        std::sin(angle * 2.0f) * BENCH_PATHHEIGHT * 0.5f * CHUNKPIXELSIZE
+    };
+}
+
+//++ Walls of a benchmark chunk, only depend on seed and chunk (the game's chunks are filled by the journal)
+inline void benchmarkChunk(Chunk& c, int chunkX, int chunkY, uint32_t seed) {
+    for (int y = 0; y < CHUNKSIZE; ++y) {
+        for (int x = 0; x < CHUNKSIZE; ++x) {
+            uint8_t noise = sampleNoise(int(seed), BENCH_WALLSMOOTHNESS, chunkX * CHUNKSIZE + x, chunkY * CHUNKSIZE + y);
+            Tile& t    = c.tiles[y][x];
+            t.isWall   = noise > BENCH_WALLLEVEL;
+            t.isGround = !t.isWall;
+        }
+    }
+    c.dirty = true;
+}
+
+//++ Pixel memory of a texture (4 bytes per pixel), 0 for nullptr
+inline size_t textureBytes(SDL_Texture* texture) {
+    float w = 0.0f, h = 0.0f;
+    if (!texture || !SDL_GetTextureSize(texture, &w, &h)) return 0;
+    return size_t(w) * size_t(h) * 4;
+}
+
+//++ Saves the frame rectangle of a render target as PNG, the render target is restored
+inline bool saveFramePNG(SDL_Renderer* renderer, SDL_Texture* target, const SDL_FRect& frame, const std::string& filePath) {
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, target);
+    SDL_Rect rect = {0, 0, int(frame.w), int(frame.h)};
+    SDL_Surface* surface = SDL_RenderReadPixels(renderer, &rect);
+    SDL_SetRenderTarget(renderer, previousTarget);
+
+    if (!surface) {
+        JFLX::log("Benchmark: ", std::string("SDL_RenderReadPixels failed: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    bool saved = IMG_SavePNG(surface, filePath.c_str());
+    SDL_DestroySurface(surface);
+    if (!saved) {
+        JFLX::log("Benchmark: ", "Failed to save " + filePath + ": " + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+    }
+    return saved;
+}
+
+//++ Counters of a benchmark run besides the frame times
+struct BenchmarkStats {
+    size_t frames        = 0;
+    uint64_t rebuilds    = 0;   // chunk textures rebuilt
+    size_t maxRebuilds   = 0;   // most rebuilds in one frame
+    size_t maxChunks     = 0;   // most loaded chunks
+    size_t drawCalls     = 0;
+    size_t maxDrawCalls  = 0;
+    size_t commands      = 0;
+    size_t textureBytes  = 0;   // texture memory of the last frame
+    size_t maxTextureBytes = 0;
+
+    void frame(const RenderStats& render, size_t frameRebuilds, size_t chunks, size_t bytes) {
+        ++frames;
+        rebuilds       += frameRebuilds;
+        maxRebuilds     = std::max(maxRebuilds, frameRebuilds);
+        maxChunks       = std::max(maxChunks, chunks);
+        drawCalls      += render.drawCalls;
+        maxDrawCalls    = std::max(maxDrawCalls, render.drawCalls);
+        commands       += render.commands;
+        textureBytes    = bytes;
+        maxTextureBytes = std::max(maxTextureBytes, bytes);
+    }
+
+    void report() const {
+        if (frames == 0) return;
+        char line[200];
+        std::snprintf(line, sizeof(line), "%zu frames, chunk rebuilds %llu (max %zu per frame), chunks loaded max %zu",
+            frames, (unsigned long long)rebuilds, maxRebuilds, maxChunks);
+        JFLX::log("Benchmark: ", line, JFLX::LOGTYPE::INFO);
+        std::snprintf(line, sizeof(line), "draw calls per frame mean %.1f max %zu, commands per frame mean %.1f",
+            double(drawCalls) / frames, maxDrawCalls, double(commands) / frames);
+        JFLX::log("Benchmark: ", line, JFLX::LOGTYPE::INFO);
+        std::snprintf(line, sizeof(line), "texture memory %.1f MB (max %.1f MB)",
+            textureBytes / (1024.0 * 1024.0), maxTextureBytes / (1024.0 * 1024.0));
+        JFLX::log("Benchmark: ", line, JFLX::LOGTYPE::INFO);
+    }
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL3_ttf/SDL_ttf.h>
+#include <JFLX/logging.hpp>
+
+/*
+++ Render Queue
+Gameplay / UI code records draw commands during the frame, flush() submits them in one go:
+
+- Commands are sorted by layer, inside WORLD / ENTITIES / LIGHT by texture and blend mode (their order inside the layer is not kept),
+  UI / OVERLAY keep the order they were recorded in
+- Every run of commands with the same texture and blend mode is one SDL_RenderGeometry call (4 vertices / 6 indices per sprite)
+- The render target is set once per flush and only when it differs from the current one
+- Positions are virtual coordinates, flush() scales them to the render target (see presentation.hpp)
+
+A command without texture is a filled rectangle in its color.
+*/
+enum class RENDERLAYER : uint8_t {
+    WORLD,
+    ENTITIES,
+    LIGHT,
+    UI,
+    OVERLAY
+};
+
+inline bool layerKeepsOrder(RENDERLAYER layer) {
+    return layer >= RENDERLAYER::UI;
+}
+
+struct RenderCommand {
+    RENDERLAYER layer     = RENDERLAYER::WORLD;
+    SDL_BlendMode blend   = SDL_BLENDMODE_BLEND;
+    bool flip             = false;
+    bool fullSource       = true;
+    uint32_t order        = 0;
+    SDL_Texture* texture  = nullptr;
+    SDL_FRect src         = {0, 0, 0, 0};
+    SDL_FRect dst         = {0, 0, 0, 0};
+    SDL_FColor color      = {1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+struct RenderStats {
+    size_t commands      = 0;
+    size_t drawCalls     = 0;
+    size_t targetChanges = 0;
+};
+
+class RenderQueue {
+public:
+    RenderStats lastFrame;   // stats of the last flush
+
+    //++ src nullptr = the whole texture
+    void sprite(RENDERLAYER layer, SDL_Texture* texture, const SDL_FRect* src, const SDL_FRect& dst, bool flip = false, SDL_FColor color = {1.0f, 1.0f, 1.0f, 1.0f}, SDL_BlendMode blend = SDL_BLENDMODE_BLEND) {
+        if (!texture) return;
+
+        RenderCommand& command = commands.emplace_back();
+        command.layer      = layer;
+        command.blend      = blend;
+        command.flip       = flip;
+        command.fullSource = src == nullptr;
+        command.order      = uint32_t(commands.size());
+        command.texture    = texture;
+        command.dst        = dst;
+        command.color      = color;
+        if (src) command.src = *src;
+    }
+
+    void rect(RENDERLAYER layer, const SDL_FRect& dst, SDL_FColor color, SDL_BlendMode blend = SDL_BLENDMODE_BLEND) {
+        RenderCommand& command = commands.emplace_back();
+        command.layer = layer;
+        command.blend = blend;
+        command.order = uint32_t(commands.size());
+        command.dst   = dst;
+        command.color = color;
+    }
+
+    //++ Submits and clears every recorded command, target = render target of the frame (nullptr = window), scale = virtual -> target pixels
+    void flush(SDL_Renderer* renderer, SDL_Texture* target, float scale = 1.0f) {
+        lastFrame = {};
+        lastFrame.commands = commands.size();
+
+        if (SDL_GetRenderTarget(renderer) != target) {
+            SDL_SetRenderTarget(renderer, target);
+            ++lastFrame.targetChanges;
+        }
+
+        std::sort(commands.begin(), commands.end(), [](const RenderCommand& a, const RenderCommand& b) {
+            if (a.layer != b.layer) return a.layer < b.layer;
+            if (!layerKeepsOrder(a.layer)) {
+                if (a.texture != b.texture) return a.texture < b.texture;
+                if (a.blend != b.blend) return a.blend < b.blend;
+            }
+            return a.order < b.order;
+        });
+
+        size_t begin = 0;
+        while (begin < commands.size()) {
+            size_t end = begin + 1;
+            while (end < commands.size() && commands[end].texture == commands[begin].texture && commands[end].blend == commands[begin].blend) {
+                ++end;
+            }
+            submitBatch(renderer, begin, end, scale);
+            begin = end;
+        }
+
+        commands.clear();
+    }
+
+private:
+    std::vector<RenderCommand> commands;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    void submitBatch(SDL_Renderer* renderer, size_t begin, size_t end, float scale) {
+        SDL_Texture* texture = commands[begin].texture;
+        float textureW = 1.0f, textureH = 1.0f;
+        if (texture) {
+            if (!SDL_GetTextureSize(texture, &textureW, &textureH)) {
+                JFLX::log("Render Queue: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                return;
+            }
+            SDL_SetTextureBlendMode(texture, commands[begin].blend);
+        } else {
+            SDL_SetRenderDrawBlendMode(renderer, commands[begin].blend);
+        }
+
+        vertices.clear();
+        indices.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const RenderCommand& command = commands[i];
+            SDL_FRect src = command.fullSource ? SDL_FRect{0.0f, 0.0f, textureW, textureH} : command.src;
+
+            float u0 = src.x / textureW, u1 = (src.x + src.w) / textureW;
+            float v0 = src.y / textureH, v1 = (src.y + src.h) / textureH;
+            if (command.flip) std::swap(u0, u1);
+
+            const SDL_FRect d = {command.dst.x * scale, command.dst.y * scale, command.dst.w * scale, command.dst.h * scale};
+            int first = int(vertices.size());
+            vertices.push_back({{d.x,       d.y},       command.color, {u0, v0}});
+            vertices.push_back({{d.x + d.w, d.y},       command.color, {u1, v0}});
+            vertices.push_back({{d.x + d.w, d.y + d.h}, command.color, {u1, v1}});
+            vertices.push_back({{d.x,       d.y + d.h}, command.color, {u0, v1}});
+            indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+        }
+
+        if (!SDL_RenderGeometry(renderer, texture, vertices.data(), int(vertices.size()), indices.data(), int(indices.size()))) {
+            JFLX::log("Render Queue: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
+        }
+        ++lastFrame.drawCalls;
+    }
+};
+
+/*
+++ Text Textures
+Rendering a text with SDL_ttf and uploading it is far more expensive than drawing it, so every (font, text, color)
+keeps its texture while it is drawn. Textures not drawn for TEXTCACHE_FRAMES frames are destroyed in endFrame().
+*/
+static constexpr uint32_t TEXTCACHE_FRAMES = 120;
+
+struct CachedText {
+    SDL_Texture* texture = nullptr;
+    float width  = 0.0f;
+    float height = 0.0f;
+    uint32_t lastUsed = 0;
+};
+
+class TextCache {
+public:
+    ~TextCache() {
+        clear();
+    }
+
+    //++ nullptr when the text could not be rendered
+    const CachedText* get(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color) {
+        std::string key = makeKey(font, text, color);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            it->second.lastUsed = frame;
+            return &it->second;
+        }
+
+        SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), text.size(), color);
+        if (!surface) {
+            JFLX::log("Failed to render text: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
+            return nullptr;
+        }
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_DestroySurface(surface);
+        if (!texture) {
+            JFLX::log("Failed to create text texture: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
+            return nullptr;
+        }
+
+        CachedText entry;
+        entry.texture  = texture;
+        entry.lastUsed = frame;
+        SDL_GetTextureSize(texture, &entry.width, &entry.height);
+        return &(entries[key] = entry);
+    }
+
+    void endFrame() {
+        ++frame;
+        for (auto it = entries.begin(); it != entries.end(); ) {
+            if (frame - it->second.lastUsed > TEXTCACHE_FRAMES) {
+                SDL_DestroyTexture(it->second.texture);
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void clear() {
+        for (auto& [key, entry] : entries) {
+            SDL_DestroyTexture(entry.texture);
+        }
+        entries.clear();
+    }
+
+private:
+    std::unordered_map<std::string, CachedText> entries;
+    uint32_t frame = 0;
+
+    static std::string makeKey(TTF_Font* font, const std::string& text, SDL_Color color) {
+        std::string key(sizeof(font) + sizeof(color), '\0');
+        std::memcpy(key.data(), &font, sizeof(font));
+        std::memcpy(key.data() + sizeof(font), &color, sizeof(color));
+        return key + text;
+    }
+};
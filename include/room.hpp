@@ -3,25 +3,33 @@
 #include "JFLX/logging.hpp"
 #include <iostream>
 #include <cstdint>
+#include <cmath>
 
 //++ Data Structures
 #include <array>
 #include <vector>
 #include <deque>
+#include <unordered_map>
+#include <functional>
 
 #include <SDL3/SDL.h>
 
-#include "player.hpp"
+#include "interactables.hpp"
+#include "renderQueue.hpp"
 
 struct Chunk;
 
 static constexpr int CHUNKSIZE = 16;
 static constexpr int TILESIZE   = 64;
 static constexpr int CHUNKPIXELSIZE   = CHUNKSIZE * TILESIZE;
+static constexpr int CHUNKLOADRADIUS  = 2;    // chunks loaded around the player, movement and collision never create chunks
 
 std::deque<Chunk*> generationQueue;
 std::vector<Chunk*> allChuncks;
 
+//++ Last revision given to a chunk, revisions are unique over all chunks (a chunk loaded again never matches an old cache)
+static uint32_t chunkRevisions = 0;
+
 enum NeighbourBits : uint8_t {
     UP    = 1 << 0, // 0001
     LEFT  = 1 << 1, // 0010
@@ -31,17 +39,14 @@ enum NeighbourBits : uint8_t {
 
 /*
 ++ A simple Struct for Storing Index Data
+Loot, search state and decoration are rare and live in Chunk::interactables, not here (3 bytes per tile)
 */
 struct Tile {
-    // Basic type flags
-    bool isWall            = false;
-    bool isGround          = false;
-    bool isLocker          = false;
-    bool isShelf           = false;
-
-    // Interaction
-    bool searchable        = false;
-    bool wasSearched       = false;
+    // Basic type flags (no default initializers on bit-fields before C++20, Chunk value-initializes its tiles = all false)
+    bool isWall   : 1;
+    bool isGround : 1;
+    bool isLocker : 1;
+    bool isShelf  : 1;
 
     // Identity
     uint8_t tileID         = 0;
@@ -49,13 +54,9 @@ struct Tile {
     // Texture ID
     uint8_t tilemapID      = 0;
 
-    // Decoration
-    bool hasDecor          = false;
-    uint8_t decorID        = 0;
-
-    // Items
-    bool hasItem           = false;
-    uint8_t itemID         = 0;
+    bool searchable() const {
+        return isLocker || isShelf;
+    }
 };
 
 /*
@@ -63,10 +64,18 @@ struct Tile {
 */
 struct Chunk {
     uint32_t id = 0;
-    bool dirty = true;
+    bool dirty = true;             // tiles changed: autotile, new revision and a new texture
+    bool textureStale = false;     // only the texture is redrawn (tileset reloaded, render targets lost), the tiles are the same
+
+    //++ Increased by autotileChunk, caches built from the tiles (lighting) compare against it
+    uint32_t revision = 0;
 
     Tile tiles[CHUNKSIZE][CHUNKSIZE]{};
     SDL_Texture* texture = nullptr;
+    uint32_t tilesetID = UINT32_MAX;   // tileset the texture was built with (texture handle index)
+
+    //++ Searched tiles and decoration, sparse
+    ChunkInteractables interactables;
 
     explicit Chunk(uint32_t id_) : id(id_) {}
 
@@ -78,6 +87,22 @@ struct Chunk {
 };
 
 
+inline uint8_t tileIndex(int x, int y) {
+    return uint8_t(y * CHUNKSIZE + x);
+}
+
+/*
+++ Searches a locker / shelf of the chunk (chunk local x, y)
+The loot is rolled on the first search of the tile, nullptr when the tile can not be searched
+*/
+SearchedTile* searchTile(Chunk& c, int chunkX, int chunkY, int x, int y, uint32_t worldSeed, const LootTable& table) {
+    Tile* t = c.get(x, y);
+    if (!t || !t->searchable()) return nullptr;
+
+    LOOTKIND kind = t->isLocker ? LOOTKIND::LOCKER : LOOTKIND::SHELF;
+    return &c.interactables.search(tileIndex(x, y), kind, chunkSeed(worldSeed, chunkX, chunkY), table);
+}
+
 inline bool isWallAt(Chunk& c, int x, int y) {
     Tile* t = c.get(x, y);
     return t && t->isWall;
@@ -108,27 +133,39 @@ void autotileChunk(Chunk& c) {
         }
     }
 
+    c.revision = ++chunkRevisions;
     c.dirty = true;
 }
 
+/*
+++ Rebuild the Texture of a Chunk
+The texture is created once and redrawn in place, all tiles are one batch (one draw call).
+!! Leaves the chunk texture as render target, ChunkManager::update restores the target once after all rebuilds !!
+*/
+static RenderQueue chunkRenderQueue;
+
 void rebuildChunkTexture(SDL_Renderer* renderer, SDL_Texture* tileset, Chunk& chunk) {
-    if (chunk.texture)
-        SDL_DestroyTexture(chunk.texture);
-
-    chunk.texture = SDL_CreateTexture(
-        renderer,
-        SDL_PIXELFORMAT_RGBA32,
-        SDL_TEXTUREACCESS_TARGET,
-        CHUNKSIZE * TILESIZE,
-        CHUNKSIZE * TILESIZE
-    );
-
-    SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+    if (!chunk.texture) {
+        chunk.texture = SDL_CreateTexture(
+            renderer,
+            SDL_PIXELFORMAT_RGBA32,
+            SDL_TEXTUREACCESS_TARGET,
+            CHUNKSIZE * TILESIZE,
+            CHUNKSIZE * TILESIZE
+        );
+        SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+    }
+
     SDL_SetRenderTarget(renderer, chunk.texture);
     SDL_RenderClear(renderer);
 
-    float tsW, tsH;
-    SDL_GetTextureSize(tileset, &tsW, &tsH);
+    float tsW = 0, tsH = 0;
+    if (!tileset || !SDL_GetTextureSize(tileset, &tsW, &tsH)) {
+        JFLX::log("Chunk: ", "No tileset to rebuild the chunk texture with", JFLX::LOGTYPE::ERROR);
+        chunk.dirty = false;
+        chunk.textureStale = false;
+        return;
+    }
     int tilesPerRow = int(tsW) / TILESIZE;
 
     for (int y = 0; y < CHUNKSIZE; ++y) {
@@ -150,24 +187,40 @@ void rebuildChunkTexture(SDL_Renderer* renderer, SDL_Texture* tileset, Chunk& ch
                 float(TILESIZE)
             };
 
-            SDL_RenderTexture(renderer, tileset, &src, &dst);
+            chunkRenderQueue.sprite(RENDERLAYER::WORLD, tileset, &src, dst);
         }
     }
 
-    SDL_SetRenderTarget(renderer, nullptr);
+    chunkRenderQueue.flush(renderer, chunk.texture);
     chunk.dirty = false;
+    chunk.textureStale = false;
 }
 
 inline int worldToChunk(float worldPos) {
     return int(std::floor(worldPos / CHUNKPIXELSIZE));
 }
 
-inline int worldToLocalTile(float worldPos) {
+//++ Global tile index of a world position (pixels)
+inline int worldToTile(float worldPos) {
     return int(std::floor(worldPos / TILESIZE));
 }
 
+//++ Chunk of a global tile index, rounds down for negative tiles
+inline int tileToChunk(int tile) {
+    return tile >= 0 ? tile / CHUNKSIZE : (tile + 1) / CHUNKSIZE - 1;
+}
+
+//++ Tile index inside its chunk (0 .. CHUNKSIZE-1), also for negative tiles
+inline int tileToLocal(int tile) {
+    return tile - tileToChunk(tile) * CHUNKSIZE;
+}
 
-void renderChunk(SDL_Renderer* renderer, const Chunk& chunk, float worldX, float worldY) {
+inline int worldToLocalTile(float worldPos) {
+    return tileToLocal(worldToTile(worldPos));
+}
+
+
+void renderChunk(RenderQueue& queue, const Chunk& chunk, float worldX, float worldY) {
     if (!chunk.texture) return;
 
     SDL_FRect dst {
@@ -177,12 +230,18 @@ void renderChunk(SDL_Renderer* renderer, const Chunk& chunk, float worldX, float
         float(CHUNKSIZE * TILESIZE)
     };
 
-    SDL_RenderTexture(renderer, chunk.texture, nullptr, &dst);
+    queue.sprite(RENDERLAYER::WORLD, chunk.texture, nullptr, dst);
 }
 
 struct ChunkManager {
     std::unordered_map<uint64_t, Chunk> chunks;
 
+    //++ Chunk textures rebuilt since the start (render benchmark)
+    uint64_t rebuilds = 0;
+
+    //++ Called with every new chunk and its coordinates (saved changes, spawning)
+    std::function<void(Chunk&, int, int)> onCreate;
+
     inline int64_t chunkKey(int x, int y) {
         return (int64_t(x) << 32) | uint32_t(y);
     }
@@ -197,27 +256,90 @@ struct ChunkManager {
         if (it != chunks.end()) {
             return &it->second;
         } else {
-            Chunk newChunk(uint32_t(chunks.size()));
-            chunks[key] = newChunk;
-            return &chunks[key];
+            //-> Chunk has no default constructor, so operator[] can not be used
+            Chunk* created = &chunks.try_emplace(key, uint32_t(chunks.size())).first->second;
+            if (onCreate) onCreate(*created, chunkX, chunkY);
+            return created;
         }
     }
 
-    void update(SDL_Renderer* renderer, SDL_Texture* tileset) {
+    //++ Chunk at given Coordinates or nullptr, never creates one
+    Chunk* findChunk(int chunkX, int chunkY) {
+        auto it = chunks.find(chunkKey(chunkX, chunkY));
+        return it != chunks.end() ? &it->second : nullptr;
+    }
+
+    //++ Creates every missing chunk up to radius chunks around the given chunk
+    void loadAround(int chunkX, int chunkY, int radius) {
+        for (int cy = chunkY - radius; cy <= chunkY + radius; ++cy) {
+            for (int cx = chunkX - radius; cx <= chunkX + radius; ++cx) {
+                getChunk(cx, cy);
+            }
+        }
+    }
+
+    void update(SDL_Renderer* renderer, SDL_Texture* tileset, uint32_t tilesetID = UINT32_MAX) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        bool rebuilt = false;
         for (auto& [key, chunk] : chunks) {
             //-> Dirty when Further than 2 chunks away from the Player
-            if (chunk.dirty) {
-                autotileChunk(chunk);
-                rebuildChunkTexture(renderer, tileset, chunk);
+            if (!chunk.dirty && !chunk.textureStale) continue;
+
+            //-> Only changed tiles get a new revision (lighting and pathfinding rebuild their caches on it)
+            if (chunk.dirty) autotileChunk(chunk);
+            rebuildChunkTexture(renderer, tileset, chunk);
+            chunk.tilesetID = tilesetID;
+            rebuilt = true;
+            ++rebuilds;
+        }
+        if (rebuilt) SDL_SetRenderTarget(renderer, previousTarget);
+    }
+
+    //++ The texture of a tileset changed, only the textures of the chunks built with it are redrawn
+    void invalidateTileset(uint32_t tilesetID) {
+        for (auto& [key, chunk] : chunks) {
+            if (chunk.tilesetID == tilesetID) chunk.textureStale = true;
+        }
+    }
+
+    //++ Every chunk texture is redrawn (other tileset, lost render targets), the tiles stay as they are
+    void invalidateTextures() {
+        for (auto& [key, chunk] : chunks) {
+            chunk.textureStale = true;
+        }
+    }
+
+    /*
+    ++ Records every chunk at its world position
+    With a view (world rectangle) only the chunks inside of it are recorded, relative to its top left corner
+    */
+    void render(RenderQueue& queue, const SDL_FRect* view = nullptr) {
+        for (const auto& [key, chunk] : chunks) {
+            float wx = float(int32_t(key >> 32) * CHUNKPIXELSIZE);
+            float wy = float(int32_t(uint32_t(key)) * CHUNKPIXELSIZE);
+            if (view) {
+                if (wx + CHUNKPIXELSIZE <= view->x || wy + CHUNKPIXELSIZE <= view->y || wx >= view->x + view->w || wy >= view->y + view->h) continue;
+                wx -= view->x;
+                wy -= view->y;
             }
+            renderChunk(queue, chunk, wx, wy);
         }
     }
 
-    void render(SDL_Renderer* renderer) {
-        for (auto key : chunks) {
-            float wx = float(key.first * CHUNKSIZE * TILESIZE);
-            float wy = 0.0f;
-            renderChunk(renderer, key.second, wx, wy);
+    //++ Destroys the chunks (and their textures) outside of the chunk coordinates min .. max, returns how many
+    size_t unloadOutside(int minChunkX, int minChunkY, int maxChunkX, int maxChunkY) {
+        size_t removed = 0;
+        for (auto it = chunks.begin(); it != chunks.end();) {
+            int chunkX = int32_t(it->first >> 32);
+            int chunkY = int32_t(uint32_t(it->first));
+            if (chunkX >= minChunkX && chunkX <= maxChunkX && chunkY >= minChunkY && chunkY <= maxChunkY) {
+                ++it;
+                continue;
+            }
+            if (it->second.texture) SDL_DestroyTexture(it->second.texture);
+            it = chunks.erase(it);
+            ++removed;
         }
+        return removed;
     }
 };
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <atomic>
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL3_image/SDL_image.h>
+#include <JFLX/logging.hpp>
+
+#include "fileWatcher.hpp"
+
+/*
+++ Texture Store
+Every texture by name behind a TextureHandle, the handle of a name never changes, the SDL_Texture behind it can:
+
+- watch() starts a FileWatcher on every texture file, a changed file is decoded (IMG_Load) on the watcher thread
+- update() uploads the decoded images on the main thread (the renderer is not thread safe), destroys the old textures
+  and returns the handles that changed, so only what used them has to be rebuilt (e.g. chunks of a tileset)
+
+!! Do not keep the SDL_Texture* of get() / find() across frames, keep the handle !!
+*/
+struct TextureHandle {
+    uint32_t index = UINT32_MAX;
+
+    bool valid() const {
+        return index != UINT32_MAX;
+    }
+};
+
+class TextureStore {
+public:
+    TextureStore() = default;
+
+    ~TextureStore() {
+        watcher.stop();
+    }
+
+    TextureStore(const TextureStore&) = delete;
+    TextureStore& operator=(const TextureStore&) = delete;
+
+    //++ Adds a loaded texture, a name that exists already keeps its handle and gets the new texture
+    TextureHandle add(const std::string& name, const std::string& filePath, SDL_Texture* texture) {
+        auto it = byName.find(name);
+        if (it != byName.end()) {
+            Entry& entry = entries[it->second];
+            if (entry.texture) SDL_DestroyTexture(entry.texture);
+            entry.filePath = filePath;
+            entry.texture  = texture;
+            return {it->second};
+        }
+
+        uint32_t index = uint32_t(entries.size());
+        entries.push_back({name, filePath, texture});
+        byName.emplace(name, index);
+        return {index};
+    }
+
+    //++ Invalid handle for unknown names
+    TextureHandle handle(const std::string& name) const {
+        auto it = byName.find(name);
+        return it != byName.end() ? TextureHandle{it->second} : TextureHandle{};
+    }
+
+    SDL_Texture* get(TextureHandle textureHandle) const {
+        return textureHandle.index < entries.size() ? entries[textureHandle.index].texture : nullptr;
+    }
+
+    //++ nullptr for unknown names
+    SDL_Texture* find(const std::string& name) const {
+        return get(handle(name));
+    }
+
+    //++ Pixel memory of all textures (4 bytes per pixel)
+    size_t textureBytes() const {
+        size_t bytes = 0;
+        for (const Entry& entry : entries) {
+            float w = 0.0f, h = 0.0f;
+            if (entry.texture && SDL_GetTextureSize(entry.texture, &w, &h)) bytes += size_t(w) * size_t(h) * 4;
+        }
+        return bytes;
+    }
+
+    //++ Watches every added texture file, call it once after all textures were added
+    void watch() {
+        for (uint32_t index = 0; index < entries.size(); ++index) {
+            std::string filePath = entries[index].filePath;
+            watcher.watch(filePath, [this, index, filePath]() {
+                SDL_Surface* surface = IMG_Load(filePath.c_str());
+                if (!surface) {
+                    JFLX::log("Texture Store: ", "Failed to decode " + filePath + ": " + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                decoded.emplace_back(index, surface);
+                hasDecoded = true;
+            });
+        }
+        watcher.start();
+    }
+
+    //++ A changed texture waits for update()
+    bool pending() const {
+        return hasDecoded.load(std::memory_order_acquire);
+    }
+
+    //++ Main thread: swaps in the decoded textures, returns the handles that changed
+    std::vector<TextureHandle> update(SDL_Renderer* renderer) {
+        std::vector<TextureHandle> changed;
+        if (!pending()) return changed;
+
+        std::vector<std::pair<uint32_t, SDL_Surface*>> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.swap(decoded);
+            hasDecoded = false;
+        }
+
+        for (auto& [index, surface] : ready) {
+            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+            SDL_DestroySurface(surface);
+            if (!texture) {
+                JFLX::log("Texture Store: ", "Failed to upload " + entries[index].name + ": " + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                continue;
+            }
+
+            //-> The new texture is drawn like the old one
+            Entry& entry = entries[index];
+            if (entry.texture) {
+                SDL_BlendMode blendMode;
+                SDL_ScaleMode scaleMode;
+                if (SDL_GetTextureBlendMode(entry.texture, &blendMode)) SDL_SetTextureBlendMode(texture, blendMode);
+                if (SDL_GetTextureScaleMode(entry.texture, &scaleMode)) SDL_SetTextureScaleMode(texture, scaleMode);
+                SDL_DestroyTexture(entry.texture);
+            }
+            entry.texture = texture;
+            changed.push_back({index});
+            JFLX::log("Texture Store: ", "Reloaded " + entry.name, JFLX::LOGTYPE::SUCCESS);
+        }
+        return changed;
+    }
+
+    //++ Stops watching and destroys every texture (before the renderer is destroyed)
+    void clear() {
+        watcher.stop();
+        for (Entry& entry : entries) {
+            if (entry.texture) SDL_DestroyTexture(entry.texture);
+        }
+        entries.clear();
+        byName.clear();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& [index, surface] : decoded) {
+            SDL_DestroySurface(surface);
+        }
+        decoded.clear();
+        hasDecoded = false;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string filePath;
+        SDL_Texture* texture = nullptr;
+    };
+
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, uint32_t> byName;
+
+    FileWatcher watcher;
+    std::mutex mutex;
+    std::vector<std::pair<uint32_t, SDL_Surface*>> decoded;   // guarded by mutex
+    std::atomic<bool> hasDecoded{false};
+};
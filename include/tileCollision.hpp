@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <algorithm>
+
+#include "room.hpp"
+#include "player.hpp"
+
+/*
+++ Tile Collision
+Moves an axis aligned box (the player) through the wall tiles of the ChunkManager.
+
+The movement of a frame is split into at most COLLISION_MAXSTEPS steps of at most one tile per axis.
+Every step first fetches the chunks under the swept box once (CollisionWindow), then sweeps X and Y separately:
+only the tile columns / rows the leading edge enters are tested, the box is snapped to the edge of the first wall and reports a contact normal.
+Tiles the box already overlaps never block, so a box that spawned inside a wall can walk out of it.
+
+The cost per frame is bounded by COLLISION_MAXSTEPS * (tiles along the box edge), independent of the frame time,
+movement beyond COLLISION_MAXSTEPS tiles per frame is dropped.
+
+!! The box must be smaller than CHUNKPIXELSIZE - 4 * TILESIZE, otherwise a step can touch more than 2x2 chunks !!
+*/
+static constexpr int COLLISION_MAXSTEPS = 4;
+
+struct CollisionResult {
+    //++ -1 / 0 / +1, points away from the wall that was hit (hit a wall on the right = normalX -1)
+    int normalX = 0;
+    int normalY = 0;
+
+    //++ Distance actually moved in pixels
+    float movedX = 0.0f;
+    float movedY = 0.0f;
+
+    bool hit() const {
+        return normalX != 0 || normalY != 0;
+    }
+};
+
+/*
+++ The (up to 2x2) chunks one step can touch
+Chunks are fetched once when the window is placed, tile lookups are then an index into the window.
+Chunks are only looked up, never created: an unloaded chunk is solid, the game decides which chunks are loaded.
+*/
+struct CollisionWindow {
+    int chunkX = 0;
+    int chunkY = 0;
+    int chunksX = 0;
+    int chunksY = 0;
+    std::array<Chunk*, 4> chunks{};
+
+    void place(ChunkManager& mgr, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY) {
+        chunkX  = tileToChunk(tileMinX);
+        chunkY  = tileToChunk(tileMinY);
+        chunksX = std::min(2, tileToChunk(tileMaxX) - chunkX + 1);
+        chunksY = std::min(2, tileToChunk(tileMaxY) - chunkY + 1);
+
+        for (int cy = 0; cy < chunksY; ++cy) {
+            for (int cx = 0; cx < chunksX; ++cx) {
+                chunks[cy * 2 + cx] = mgr.findChunk(chunkX + cx, chunkY + cy);
+            }
+        }
+    }
+
+    //++ Global tile coordinates, tiles outside of the window are solid
+    bool isWall(int tileX, int tileY) const {
+        int cx = tileToChunk(tileX) - chunkX;
+        int cy = tileToChunk(tileY) - chunkY;
+        if (cx < 0 || cy < 0 || cx >= chunksX || cy >= chunksY) return true;
+
+        Chunk* c = chunks[cy * 2 + cx];
+        return !c || c->tiles[tileToLocal(tileY)][tileToLocal(tileX)].isWall;
+    }
+};
+
+//++ First tile index at or after the pixel (exclusive end of a box edge)
+inline int tileCeil(float worldPos) {
+    return int(std::ceil(worldPos / TILESIZE));
+}
+
+/*
+++ Sweeps the box along X by dx, x is moved
+Only the columns between the leading edge and the leading edge + dx are tested, against the rows the box covers.
+A blocked box is placed exactly on the edge of the wall (not moved by a float distance), so it stays flush frame after frame.
+*/
+inline void sweepX(const CollisionWindow& window, float& x, float y, float w, float h, float dx, int& normalX) {
+    if (dx == 0.0f) return;
+
+    int rowBegin = worldToTile(y);
+    int rowEnd   = tileCeil(y + h);
+
+    if (dx > 0.0f) {
+        for (int col = tileCeil(x + w); col < tileCeil(x + w + dx); ++col) {
+            for (int row = rowBegin; row < rowEnd; ++row) {
+                if (window.isWall(col, row)) {
+                    normalX = -1;
+                    x = float(col * TILESIZE) - w;
+                    return;
+                }
+            }
+        }
+    } else {
+        for (int col = worldToTile(x) - 1; col >= worldToTile(x + dx); --col) {
+            for (int row = rowBegin; row < rowEnd; ++row) {
+                if (window.isWall(col, row)) {
+                    normalX = 1;
+                    x = float((col + 1) * TILESIZE);
+                    return;
+                }
+            }
+        }
+    }
+    x += dx;
+}
+
+//++ Same as sweepX with the axes swapped
+inline void sweepY(const CollisionWindow& window, float x, float& y, float w, float h, float dy, int& normalY) {
+    if (dy == 0.0f) return;
+
+    int colBegin = worldToTile(x);
+    int colEnd   = tileCeil(x + w);
+
+    if (dy > 0.0f) {
+        for (int row = tileCeil(y + h); row < tileCeil(y + h + dy); ++row) {
+            for (int col = colBegin; col < colEnd; ++col) {
+                if (window.isWall(col, row)) {
+                    normalY = -1;
+                    y = float(row * TILESIZE) - h;
+                    return;
+                }
+            }
+        }
+    } else {
+        for (int row = worldToTile(y) - 1; row >= worldToTile(y + dy); --row) {
+            for (int col = colBegin; col < colEnd; ++col) {
+                if (window.isWall(col, row)) {
+                    normalY = 1;
+                    y = float((row + 1) * TILESIZE);
+                    return;
+                }
+            }
+        }
+    }
+    y += dy;
+}
+
+/*
+++ Moves the box at (x, y) by (dx, dy) against the wall tiles
+x / y are updated, the velocity is left to the caller (see movePlayer)
+*/
+CollisionResult moveBox(ChunkManager& mgr, float& x, float& y, float w, float h, float dx, float dy) {
+    CollisionResult result;
+    float startX = x;
+    float startY = y;
+
+    float longest = std::max(std::fabs(dx), std::fabs(dy));
+    int steps = std::clamp(int(std::ceil(longest / TILESIZE)), 1, COLLISION_MAXSTEPS);
+    float stepX = std::clamp(dx / steps, -float(TILESIZE), float(TILESIZE));
+    float stepY = std::clamp(dy / steps, -float(TILESIZE), float(TILESIZE));
+
+    CollisionWindow window;
+    for (int step = 0; step < steps; ++step) {
+        //-> Swept box of this step, grown by one tile for the "already touching" edge columns
+        window.place(mgr,
+            worldToTile(std::min(x, x + stepX)) - 1, worldToTile(std::min(y, y + stepY)) - 1,
+            worldToTile(std::max(x + w, x + w + stepX)) + 1, worldToTile(std::max(y + h, y + h + stepY)) + 1);
+
+        if (result.normalX == 0) sweepX(window, x, y, w, h, stepX, result.normalX);
+        if (result.normalY == 0) sweepY(window, x, y, w, h, stepY, result.normalY);
+        if (result.normalX != 0 && result.normalY != 0) break;
+    }
+
+    result.movedX = x - startX;
+    result.movedY = y - startY;
+
+    return result;
+}
+
+//++ Moves the player by its velocity, the velocity along a hit normal is cleared
+CollisionResult movePlayer(ChunkManager& mgr, Player& p, float deltaTime) {
+    CollisionResult result = moveBox(mgr, p.x, p.y, p.width, p.height, p.vx * deltaTime, p.vy * deltaTime);
+
+    if (result.normalX != 0) p.vx = 0.0f;
+    if (result.normalY != 0) p.vy = 0.0f;
+    return result;
+}
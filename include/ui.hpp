@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL3_ttf/SDL_ttf.h>
+#include <JFLX/logging.hpp>
+
+#include "renderQueue.hpp"
+#include "presentation.hpp"
+
+/*
+++ Retained Menu UI
+Menu screens (title, main menu, settings) are lists of widgets that keep their state between frames.
+
+- Input only changes widget state (hover, value), a widget whose state changed is marked dirty
+- A screen is drawn into its own texture, only the rectangles of dirty widgets are redrawn (whole screen on the first draw)
+- Every frame the cached texture is one sprite, a screen without dirty widgets costs no text / widget drawing at all
+- Actions (buttons, changed values) are returned as UIEvents, the game applies them (settings, state changes),
+  nothing is polled per frame
+
+idle() tells the main loop that nothing on the screen changed, so it can wait for input instead of drawing frames.
+*/
+static constexpr SDL_Color UI_BACKGROUND  = { 20,  20,  80, 255};
+static constexpr SDL_Color UI_WIDGET      = { 56,  56,  56, 255};
+static constexpr SDL_Color UI_HOVERED     = { 90,  90,  90, 255};
+static constexpr SDL_Color UI_FILL        = {200, 200, 200, 255};
+static constexpr SDL_Color UI_TEXT        = {255, 255, 255, 255};
+static constexpr float UI_PADDING         = 16.0f;
+static constexpr int UI_IDLEWAITMS        = 250;     // longest wait for input while a menu is idle
+
+enum class WIDGETTYPE : uint8_t {
+    LABEL,
+    BUTTON,
+    SLIDER,
+    TOGGLE
+};
+
+enum class UIACTION : uint8_t {
+    NONE,
+    START,
+    PLAY,
+    SETTINGS,
+    BACK,
+    QUIT,
+    MUSICVOLUME,
+    SFXVOLUME,
+    RENDERQUALITY,
+    DYNAMICRESOLUTION
+};
+
+struct UIEvent {
+    UIACTION action = UIACTION::NONE;
+    int value = 0;
+};
+
+struct Widget {
+    WIDGETTYPE type  = WIDGETTYPE::LABEL;
+    UIACTION action  = UIACTION::NONE;
+    std::string label;
+    SDL_FRect rect   = {0, 0, 0, 0};
+    int value        = 0;
+    int minValue     = 0;
+    int maxValue     = 100;
+    int step         = 1;
+    bool hovered     = false;
+    bool dirty       = true;
+
+    bool contains(SDL_FPoint point) const {
+        return point.x >= rect.x && point.x < rect.x + rect.w && point.y >= rect.y && point.y < rect.y + rect.h;
+    }
+};
+
+inline SDL_FColor toFColor(SDL_Color color) {
+    return {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f};
+}
+
+class UIScreen {
+public:
+    std::vector<Widget> widgets;
+
+    UIScreen() = default;
+
+    ~UIScreen() {
+        destroy();
+    }
+
+    UIScreen(const UIScreen&) = delete;
+    UIScreen& operator=(const UIScreen&) = delete;
+
+    Widget& label(const std::string& text, SDL_FRect rect) {
+        return add(WIDGETTYPE::LABEL, UIACTION::NONE, text, rect);
+    }
+
+    Widget& button(const std::string& text, UIACTION action, SDL_FRect rect) {
+        return add(WIDGETTYPE::BUTTON, action, text, rect);
+    }
+
+    Widget& slider(const std::string& text, UIACTION action, SDL_FRect rect, int minValue, int maxValue, int step) {
+        Widget& widget  = add(WIDGETTYPE::SLIDER, action, text, rect);
+        widget.minValue = minValue;
+        widget.maxValue = maxValue;
+        widget.step     = std::max(step, 1);
+        widget.value    = minValue;
+        return widget;
+    }
+
+    Widget& toggle(const std::string& text, UIACTION action, SDL_FRect rect) {
+        return add(WIDGETTYPE::TOGGLE, action, text, rect);
+    }
+
+    //++ Sets the value shown by a widget without an event (e.g. from the loaded settings)
+    void setValue(UIACTION action, int value) {
+        for (Widget& widget : widgets) {
+            if (widget.action != action) continue;
+            value = std::clamp(value, widget.minValue, widget.maxValue);
+            if (widget.value != value) {
+                widget.value = value;
+                markDirty(widget);
+            }
+        }
+    }
+
+    //++ Returns true when the mouse entered a button / slider / toggle (hover sound)
+    bool mouseMove(SDL_FPoint point) {
+        bool entered = false;
+        for (Widget& widget : widgets) {
+            bool hovered = widget.type != WIDGETTYPE::LABEL && widget.contains(point);
+            if (hovered != widget.hovered) {
+                widget.hovered = hovered;
+                markDirty(widget);
+                entered |= hovered;
+            }
+        }
+        return entered;
+    }
+
+    //++ Left click, appends the resulting events
+    void mouseClick(SDL_FPoint point, std::vector<UIEvent>& events) {
+        for (Widget& widget : widgets) {
+            if (widget.type == WIDGETTYPE::LABEL || !widget.contains(point)) continue;
+
+            switch (widget.type) {
+                case WIDGETTYPE::BUTTON: {
+                    events.push_back({widget.action, 0});
+                    break;
+                }
+                case WIDGETTYPE::SLIDER: {
+                    //-> The bar is the right half of the widget, the left half shows the label
+                    SDL_FRect bar = sliderBar(widget);
+                    float t = std::clamp((point.x - bar.x) / bar.w, 0.0f, 1.0f);
+                    int value = widget.minValue + int(std::round(t * (widget.maxValue - widget.minValue) / widget.step)) * widget.step;
+                    value = std::clamp(value, widget.minValue, widget.maxValue);
+                    if (value != widget.value) {
+                        widget.value = value;
+                        markDirty(widget);
+                        events.push_back({widget.action, value});
+                    }
+                    break;
+                }
+                case WIDGETTYPE::TOGGLE: {
+                    widget.value = widget.value ? 0 : 1;
+                    markDirty(widget);
+                    events.push_back({widget.action, widget.value});
+                    break;
+                }
+                default:
+                    break;
+            }
+            return;
+        }
+    }
+
+    //++ The whole screen is redrawn on the next frame (e.g. after the cache was lost)
+    void invalidate() {
+        fullRedraw = true;
+        anyDirty   = true;
+    }
+
+    //++ Nothing changed since the last draw
+    bool idle() const {
+        return !anyDirty;
+    }
+
+    //++ Redraws the dirty widgets into the cache and records the cache as one sprite
+    void render(SDL_Renderer* renderer, RenderQueue& queue, TextCache& texts, TTF_Font* font) {
+        if (!cache) {
+            cache = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, PRESENT_VIRTUALWIDTH, PRESENT_VIRTUALHEIGHT);
+            if (!cache) {
+                JFLX::log("UI: ", std::string("SDL_CreateTexture failed: ") + SDL_GetError(), JFLX::LOGTYPE::ERROR);
+                return;
+            }
+            invalidate();
+        }
+
+        if (anyDirty) {
+            redraw(renderer, texts, font);
+        }
+        queue.sprite(RENDERLAYER::UI, cache, nullptr, {0.0f, 0.0f, float(PRESENT_VIRTUALWIDTH), float(PRESENT_VIRTUALHEIGHT)});
+    }
+
+    void destroy() {
+        if (cache) {
+            SDL_DestroyTexture(cache);
+            cache = nullptr;
+        }
+    }
+
+private:
+    SDL_Texture* cache = nullptr;
+    RenderQueue drawQueue;
+    bool fullRedraw = true;
+    bool anyDirty   = true;
+
+    Widget& add(WIDGETTYPE type, UIACTION action, const std::string& text, SDL_FRect rect) {
+        Widget& widget = widgets.emplace_back();
+        widget.type   = type;
+        widget.action = action;
+        widget.label  = text;
+        widget.rect   = rect;
+        invalidate();
+        return widget;
+    }
+
+    void markDirty(Widget& widget) {
+        widget.dirty = true;
+        anyDirty = true;
+    }
+
+    static SDL_FRect sliderBar(const Widget& widget) {
+        return {widget.rect.x + widget.rect.w * 0.5f, widget.rect.y + UI_PADDING, widget.rect.w * 0.5f - UI_PADDING, widget.rect.h - UI_PADDING * 2.0f};
+    }
+
+    void redraw(SDL_Renderer* renderer, TextCache& texts, TTF_Font* font) {
+        //-> Overwrites (no blending) the old pixels of the redrawn area with the background
+        if (fullRedraw) {
+            drawQueue.rect(RENDERLAYER::UI, {0.0f, 0.0f, float(PRESENT_VIRTUALWIDTH), float(PRESENT_VIRTUALHEIGHT)}, toFColor(UI_BACKGROUND), SDL_BLENDMODE_NONE);
+        }
+
+        for (Widget& widget : widgets) {
+            if (!widget.dirty && !fullRedraw) continue;
+            if (!fullRedraw) drawQueue.rect(RENDERLAYER::UI, widget.rect, toFColor(UI_BACKGROUND), SDL_BLENDMODE_NONE);
+            drawWidget(renderer, widget, texts, font);
+            widget.dirty = false;
+        }
+
+        drawQueue.flush(renderer, cache);
+        fullRedraw = false;
+        anyDirty   = false;
+    }
+
+    void drawWidget(SDL_Renderer* renderer, const Widget& widget, TextCache& texts, TTF_Font* font) {
+        if (widget.type != WIDGETTYPE::LABEL) {
+            drawQueue.rect(RENDERLAYER::UI, widget.rect, toFColor(widget.hovered ? UI_HOVERED : UI_WIDGET));
+        }
+
+        std::string text = widget.label;
+        if (widget.type == WIDGETTYPE::TOGGLE) text += widget.value ? ": On" : ": Off";
+        if (widget.type == WIDGETTYPE::SLIDER) text += ": " + std::to_string(widget.value);
+
+        if (widget.type == WIDGETTYPE::SLIDER) {
+            SDL_FRect bar = sliderBar(widget);
+            float t = widget.maxValue > widget.minValue ? float(widget.value - widget.minValue) / float(widget.maxValue - widget.minValue) : 0.0f;
+            drawQueue.rect(RENDERLAYER::UI, bar, toFColor(UI_BACKGROUND));
+            drawQueue.rect(RENDERLAYER::UI, {bar.x, bar.y, bar.w * t, bar.h}, toFColor(UI_FILL));
+        }
+
+        if (!font || text.empty()) return;
+        const CachedText* cachedText = texts.get(renderer, font, text, UI_TEXT);
+        if (!cachedText) return;
+
+        //-> Labels / buttons centered, sliders left aligned next to their bar
+        float x = widget.type == WIDGETTYPE::SLIDER ? widget.rect.x + UI_PADDING : widget.rect.x + (widget.rect.w - cachedText->width) * 0.5f;
+        float y = widget.rect.y + (widget.rect.h - cachedText->height) * 0.5f;
+        drawQueue.sprite(RENDERLAYER::UI, cachedText->texture, nullptr, {x, y, cachedText->width, cachedText->height});
+    }
+};
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <array>
+#include <bitset>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include <JFLX/logging.hpp>
+
+#include "room.hpp"
+#include "interactables.hpp"
+
+/*
+++ World Journal
+The explored world is never saved as a whole: chunks are generated from the seed, only what the player changed is kept.
+Every change is a 16 byte JournalRecord appended to "<name>.journal", the save grows with the player activity, not with the world.
+
+- SEARCH: tile searched, value = LOOTKIND + 1 (the loot follows from the seed and the kind, see interactables.hpp)
+- TAKE:   item taken from a slot of a searched tile
+- WALL:   wall placed (value 1) or removed (value 0)
+- DECOR:  decoration set (value = decorID, 0 = removed)
+
+record() only appends to a buffer, a background thread writes the buffer every JOURNAL_FLUSHMS milliseconds.
+When the file holds more than twice the records needed to describe the current state, the main thread hands a compacted
+copy of the state to the writer, which writes it to "<name>.journal.tmp" and renames it over the journal.
+
+Records are applied to a chunk when it is created (ChunkManager::onCreate), applying a record twice changes nothing.
+A record never depends on the tile flags of the chunk, they are not filled in yet when the chunk is created.
+
+File: magic, version, world seed | records
+*/
+static constexpr uint32_t JOURNAL_MAGIC     = 0x4A575242; // "BRWJ"
+static constexpr uint32_t JOURNAL_VERSION   = 1;
+static constexpr int JOURNAL_FLUSHMS        = 500;
+static constexpr size_t JOURNAL_MINCOMPACT  = 4096;   // records in the file before a compaction is considered
+
+enum class JOURNALRECORD : uint8_t {
+    SEARCH,
+    TAKE,
+    WALL,
+    DECOR
+};
+
+struct JournalRecord {
+    int32_t chunkX = 0;
+    int32_t chunkY = 0;
+    JOURNALRECORD type = JOURNALRECORD::SEARCH;
+    uint8_t tile  = 0;
+    uint8_t slot  = 0;
+    uint8_t reserved = 0;
+    uint16_t value   = 0;
+    uint16_t reserved2 = 0;
+};
+static_assert(sizeof(JournalRecord) == 16, "JournalRecord is written as is");
+
+class WorldJournal {
+public:
+    WorldJournal() = default;
+
+    ~WorldJournal() {
+        close();
+    }
+
+    WorldJournal(const WorldJournal&) = delete;
+    WorldJournal& operator=(const WorldJournal&) = delete;
+
+    /*
+    ++ Opens (or starts) the journal of a world and reads its records
+    A journal of another seed is moved to "<name>.journal.old" and a new one is started
+    */
+    bool open(const std::string& journalPath, uint32_t worldSeed) {
+        close();
+        filePath = journalPath;
+        seed     = worldSeed;
+        chunks.clear();
+        fileRecords = 0;
+
+        std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+
+        std::ifstream file(filePath, std::ios::binary);
+        if (file.is_open()) {
+            Header header;
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION || header.seed != seed) {
+                file.close();
+                JFLX::log("World Journal: ", "Journal does not belong to this world, starting a new one " + filePath, JFLX::LOGTYPE::WARNING);
+                std::error_code error;
+                std::filesystem::rename(filePath, filePath + ".old", error);
+            } else {
+                JournalRecord record;
+                while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+                    remember(record);
+                    ++fileRecords;
+                }
+                file.close();
+                JFLX::log("World Journal: ", "Loaded " + std::to_string(fileRecords) + " records from " + filePath, JFLX::LOGTYPE::SUCCESS);
+
+                //-> A record cut off by a crash is dropped, otherwise every record appended after it would be read shifted
+                std::error_code error;
+                uintmax_t wholeRecords = sizeof(Header) + fileRecords * sizeof(JournalRecord);
+                uintmax_t fileSize = std::filesystem::file_size(filePath, error);
+                if (!error && fileSize > wholeRecords) {
+                    std::filesystem::resize_file(filePath, wholeRecords, error);
+                    if (error) {
+                        JFLX::log("World Journal: ", "Failed to drop the cut off record of " + filePath + ": " + error.message(), JFLX::LOGTYPE::ERROR);
+                    } else {
+                        JFLX::log("World Journal: ", "Dropped a cut off record at the end of " + filePath, JFLX::LOGTYPE::WARNING);
+                    }
+                }
+            }
+        }
+
+        if (!std::filesystem::exists(filePath)) {
+            std::ofstream created(filePath, std::ios::binary);
+            Header header;
+            header.seed = seed;
+            created.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        nextCompaction = std::max(JOURNAL_MINCOMPACT, fileRecords * 2);
+        stopping = false;
+        writer = std::thread([this]() { writerLoop(); });
+        return true;
+    }
+
+    //++ Writes everything that is still buffered and stops the writer
+    void close() {
+        if (!writer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeWriter.notify_all();
+        writer.join();
+    }
+
+    //++ Main thread, never blocks on the disk
+    void record(const JournalRecord& record) {
+        remember(record);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffered.push_back(record);
+        }
+        if (++fileRecords >= nextCompaction) compact();
+    }
+
+    void recordSearch(int chunkX, int chunkY, uint8_t tile, LOOTKIND kind) {
+        record({chunkX, chunkY, JOURNALRECORD::SEARCH, tile, 0, 0, uint16_t(uint16_t(kind) + 1)});
+    }
+
+    void recordTake(int chunkX, int chunkY, uint8_t tile, int slot) {
+        record({chunkX, chunkY, JOURNALRECORD::TAKE, tile, uint8_t(slot)});
+    }
+
+    void recordWall(int chunkX, int chunkY, uint8_t tile, bool isWall) {
+        record({chunkX, chunkY, JOURNALRECORD::WALL, tile, 0, 0, uint16_t(isWall)});
+    }
+
+    void recordDecor(int chunkX, int chunkY, uint8_t tile, uint8_t decorID) {
+        record({chunkX, chunkY, JOURNALRECORD::DECOR, tile, 0, 0, decorID});
+    }
+
+    //++ Applies the changes of the chunk, call it when the chunk was created
+    void apply(Chunk& c, int chunkX, int chunkY, const LootTable& table) const {
+        auto it = chunks.find(packChunk(chunkX, chunkY));
+        if (it == chunks.end()) return;
+
+        uint32_t chunkSeedValue = chunkSeed(seed, chunkX, chunkY);
+        for (const JournalRecord& record : it->second) {
+            Tile& t = c.tiles[record.tile / CHUNKSIZE][record.tile % CHUNKSIZE];
+            switch (record.type) {
+                case JOURNALRECORD::SEARCH: {
+                    c.interactables.search(record.tile, LOOTKIND(record.value - 1), chunkSeedValue, table);
+                    break;
+                }
+                case JOURNALRECORD::TAKE: {
+                    c.interactables.take(record.tile, record.slot);
+                    break;
+                }
+                case JOURNALRECORD::WALL: {
+                    t.isWall = record.value != 0;
+                    c.dirty = true;
+                    break;
+                }
+                case JOURNALRECORD::DECOR: {
+                    c.interactables.setDecor(record.tile, uint8_t(record.value));
+                    break;
+                }
+            }
+        }
+    }
+
+    size_t recordCount() const {
+        return fileRecords;
+    }
+
+private:
+    struct Header {
+        uint32_t magic   = JOURNAL_MAGIC;
+        uint32_t version = JOURNAL_VERSION;
+        uint32_t seed    = 0;
+        uint32_t reserved = 0;
+    };
+
+    std::string filePath;
+    uint32_t seed = 0;
+
+    //++ Main thread: the records of every changed chunk, in order
+    std::unordered_map<int64_t, std::vector<JournalRecord>> chunks;
+    size_t fileRecords    = 0;
+    size_t nextCompaction = JOURNAL_MINCOMPACT;
+
+    //++ Guarded by mutex
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wakeWriter;
+    std::vector<JournalRecord> buffered;
+    std::vector<JournalRecord> compacted;
+    bool hasCompacted = false;
+    bool stopping = false;
+
+    static int64_t packChunk(int chunkX, int chunkY) {
+        return (int64_t(chunkX) << 32) | uint32_t(chunkY);
+    }
+
+    void remember(const JournalRecord& record) {
+        chunks[packChunk(record.chunkX, record.chunkY)].push_back(record);
+    }
+
+    /*
+    ++ Keeps the first SEARCH, the first TAKE of every slot and the last WALL / DECOR of a tile, in their order
+    One pass back to front: the first WALL / DECOR seen is the last one, a SEARCH / TAKE seen replaces the one kept after it
+    */
+    static void compactChunk(std::vector<JournalRecord>& records) {
+        static constexpr uint32_t NONE = UINT32_MAX;
+        std::array<uint32_t, CHUNKSIZE * CHUNKSIZE> searchAt;
+        std::array<uint32_t, CHUNKSIZE * CHUNKSIZE * LOOT_SLOTS> takeAt;
+        std::bitset<CHUNKSIZE * CHUNKSIZE> wallSeen, decorSeen;
+        searchAt.fill(NONE);
+        takeAt.fill(NONE);
+
+        std::vector<bool> keep(records.size(), false);
+        auto keepFirst = [&](uint32_t& keptAt, uint32_t i) {
+            if (keptAt != NONE) keep[keptAt] = false;
+            keptAt  = i;
+            keep[i] = true;
+        };
+        auto keepLast = [&](std::bitset<CHUNKSIZE * CHUNKSIZE>& seen, uint32_t i) {
+            if (seen[records[i].tile]) return;
+            seen.set(records[i].tile);
+            keep[i] = true;
+        };
+
+        for (uint32_t i = uint32_t(records.size()); i-- > 0; ) {
+            const JournalRecord& record = records[i];
+            switch (record.type) {
+                case JOURNALRECORD::SEARCH: keepFirst(searchAt[record.tile], i); break;
+                case JOURNALRECORD::TAKE:   if (record.slot < LOOT_SLOTS) keepFirst(takeAt[record.tile * LOOT_SLOTS + record.slot], i); break;
+                case JOURNALRECORD::WALL:   keepLast(wallSeen, i); break;
+                case JOURNALRECORD::DECOR:  keepLast(decorSeen, i); break;
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (keep[i]) records[kept++] = records[i];
+        }
+        records.resize(kept);
+    }
+
+    void compact() {
+        std::vector<JournalRecord> snapshot;
+        for (auto& [key, records] : chunks) {
+            compactChunk(records);
+            snapshot.insert(snapshot.end(), records.begin(), records.end());
+        }
+
+        if (snapshot.size() * 2 > fileRecords) {
+            nextCompaction = std::max(JOURNAL_MINCOMPACT, fileRecords * 2);
+            return;
+        }
+
+        //-> The snapshot already holds every buffered record
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffered.clear();
+            compacted.swap(snapshot);
+            hasCompacted = true;
+        }
+        wakeWriter.notify_one();
+
+        fileRecords    = compacted.size();
+        nextCompaction = std::max(JOURNAL_MINCOMPACT, fileRecords * 2);
+    }
+
+    void writerLoop() {
+        std::vector<JournalRecord> appending;
+        std::vector<JournalRecord> rewriting;
+        while (true) {
+            bool rewrite = false;
+            bool stop = false;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeWriter.wait_for(lock, std::chrono::milliseconds(JOURNAL_FLUSHMS), [this]() { return stopping || hasCompacted; });
+                if (hasCompacted) {
+                    rewriting.swap(compacted);
+                    hasCompacted = false;
+                    rewrite = true;
+                }
+                appending.swap(buffered);
+                stop = stopping;
+            }
+
+            //-> A failed rewrite is appended instead, applying records twice changes nothing
+            if (rewrite && !writeCompacted(rewriting)) {
+                appending.insert(appending.begin(), rewriting.begin(), rewriting.end());
+            }
+            rewriting.clear();
+            if (!appending.empty()) {
+                std::ofstream file(filePath, std::ios::binary | std::ios::app);
+                file.write(reinterpret_cast<const char*>(appending.data()), std::streamsize(appending.size() * sizeof(JournalRecord)));
+                if (!file) JFLX::log("World Journal: ", "Failed to append to " + filePath, JFLX::LOGTYPE::ERROR);
+                appending.clear();
+            }
+            if (stop) return;
+        }
+    }
+
+    bool writeCompacted(const std::vector<JournalRecord>& records) {
+        std::string tmpPath = filePath + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            Header header;
+            header.seed = seed;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(records.data()), std::streamsize(records.size() * sizeof(JournalRecord)));
+            if (!file) {
+                JFLX::log("World Journal: ", "Failed to write " + tmpPath, JFLX::LOGTYPE::ERROR);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tmpPath, filePath, error);
+        if (error) {
+            JFLX::log("World Journal: ", "Failed to replace " + filePath + ": " + error.message(), JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+        return true;
+    }
+};
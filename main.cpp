@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <cstdint>
+#include <charconv>
 #include <fstream>
 #include <filesystem>
 #include <unordered_map>
@@ -19,25 +20,40 @@
 #include <JFLX/jsonFunctionality.hpp>
 #include <JFLX/collision.hpp>
 #include "colorStruct.hpp"
+#include "presentation.hpp"
+#include "config.hpp"
+#include "textureStore.hpp"
+#include "audio.hpp"
+#include "inputRecording.hpp"
+#include "frameProfiler.hpp"
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
-json settings, levelData, progress;
 
 std::string path = fs::current_path().string() + "/";
 std::string dataFolder = "gameData/";
 
+//++ Config (see config.hpp), parsed once, swapped in at the start of a frame when a file changed
+std::string settingsPath  = path + dataFolder + "config/settings.json";
+std::string levelDataPath = path + dataFolder + "json/levelData.jsonc";
+std::string progressPath  = path + dataFolder + "stats/progress.json";
+
+SettingsConfig settings;   // the settings menu changes it, saved in cleanUp()
+std::shared_ptr<const LevelDataConfig> levelData = std::make_shared<LevelDataConfig>();
+ProgressConfig progress;
+
+ConfigSlot<SettingsConfig> settingsSlot;
+ConfigSlot<LevelDataConfig> levelDataSlot;
+FileWatcher configWatcher;
+
 //++ Window / Mouse / Audio Variables
 SDL_Window*     window = nullptr;
 SDL_Renderer*   renderer = nullptr;
-SDL_Texture*    renderTexture = nullptr;
-
-float scaleMousePositionFactorX = 2.0f;
-float scaleMousePositionFactorY = 2.0f;
+Presentation    presentation;   // render texture sized from the window, see presentation.hpp
 
 MIX_Mixer*      musicMixer = nullptr;
 MIX_Mixer*      soundMixer = nullptr;
-MIX_Track*      musicTrack = nullptr;
+AudioEngine     audio;          // voice pool for sound effects, music crossfades, see audio.hpp
 
 //++ Fonts
 TTF_Font* font              = nullptr;
@@ -48,11 +64,8 @@ std::string title = "Furfront";
 int windowWidth  = 960;
 int windowHeight = 540;
 
-const int virtualWidth  = 1920;
-const int virtualHeight = 1080;
-
 //++ Data-Maps
-std::unordered_map<std::string, SDL_Texture*> textureMap;
+TextureStore textures;   // every texture by name, reloaded when its file changes (textureStore.hpp)
 std::unordered_map<std::string, MIX_Audio*> soundMap;
 std::unordered_map<std::string, MIX_Audio*> musicMap;
 
@@ -67,16 +80,66 @@ enum class STATE {
 
 bool isPaused = false;
 
+//++ Command line: --record <file> / --replay <file> / --benchmark <frames> [--dump <folder>] [--dumpEvery <n>], [--headless] [--profile <csv>]
+struct LaunchOptions {
+    std::string recordPath;
+    std::string replayPath;
+    std::string profilePath;   // frame times as csv (frameProfiler.hpp)
+    bool headless = false;     // dummy video / audio driver, software renderer
+    int benchmarkFrames = 0;   // render benchmark instead of the game (renderBenchmark.hpp)
+    std::string dumpFolder;    // benchmark frames saved as PNG
+    int dumpEvery = 100;
+
+    //++ Runs that are measured: every run has to render the same work (no vsync, no dynamic resolution)
+    bool measured() const {
+        return !replayPath.empty() || benchmarkFrames > 0;
+    }
+};
+LaunchOptions launchOptions;
+
+//++ Simulation in fixed steps, input is handled at the start of a step (recorded / replayed, see inputRecording.hpp)
+static constexpr float SIM_STEP   = 1.0f / 120.0f;
+static constexpr int SIM_MAXSTEPS = 8;   // steps per frame, a longer frame slows the game down instead of catching up forever
+uint32_t simStep = 0;
+InputState input;
+InputRecorder inputRecorder;
+InputReplay inputReplay;
+std::vector<InputEvent> pendingInput;   // events of this frame, handled at the next step
+FrameProfiler profiler;
+
 STATE currentState  = STATE::TITLESCREEN;
 STATE lastState     = STATE::NONE;
 
 //++ Chunk Management
 #include "room.hpp"
+#include "player.hpp"
+#include "tileCollision.hpp"
+#include "lighting.hpp"
+#include "pathfinding.hpp"
+#include "entities.hpp"
+#include "worldJournal.hpp"
+#include "renderQueue.hpp"
+#include "ui.hpp"
+#include "renderBenchmark.hpp"
 ChunkManager chunkManager;
+LightingSystem lighting;
+PathService paths;
+EntityStore entities;
+WorldJournal journal;
+RenderQueue renderQueue;   // every 2D draw of a frame, submitted after render()
+TextCache textCache;
+
+//++ Menu screens (retained, see ui.hpp) and the events their widgets produced this frame
+UIScreen titleScreen;
+UIScreen mainMenuScreen;
+UIScreen settingsScreen;
+std::vector<UIEvent> uiEvents;
 
 //++ Level Logic
 std::string currentLevel = "0";
 std::string currentTileMap = "4x4TileGridLightedFaces";
+uint32_t worldSeed = 12345;
+LootTable levelLoot;
 
 std::unordered_map<std::string, float> frameMap = {
     {"animatedBackroundFrame", 0.0f}
@@ -108,13 +171,13 @@ int loadMusic() {
             JFLX::log("Music:", (tempName + " in " + tempPath), JFLX::LOGTYPE::INFO);
             
             //++ Load Audio from file (not streamed)
-            MIX_Audio* audio = MIX_LoadAudio(musicMixer, tempPath.c_str(), false);
-            if (!audio) {
+            MIX_Audio* music = MIX_LoadAudio(musicMixer, tempPath.c_str(), false);
+            if (!music) {
                 JFLX::log("Failed to load music from: ", (tempPath + "; " + SDL_GetError()), JFLX::LOGTYPE::ERROR);
                 continue;
             }
             
-            musicMap[tempName] = audio;
+            musicMap[tempName] = music;
             JFLX::log("Loaded Music: ", (tempPath + " as " + tempName), JFLX::LOGTYPE::SUCCESS);
         }
     }
@@ -139,13 +202,13 @@ int loadSounds() {
             JFLX::log("Sound: ", (tempName + " in " + tempPath), JFLX::LOGTYPE::INFO);
             
             //++ Load Audio from file (not streamed)
-            MIX_Audio* audio = MIX_LoadAudio(musicMixer, tempPath.c_str(), false);
-            if (!audio) {
+            MIX_Audio* sound = MIX_LoadAudio(soundMixer, tempPath.c_str(), false);
+            if (!sound) {
                 JFLX::log("Failed to load sound from: ", (tempPath + "; " + SDL_GetError()), JFLX::LOGTYPE::ERROR);
                 continue;
             }
 
-            soundMap[tempName] = audio;
+            soundMap[tempName] = sound;
             JFLX::log("Loaded Sound: ", (tempPath + " as " + tempName), JFLX::LOGTYPE::SUCCESS);
         }
     }
@@ -153,7 +216,7 @@ int loadSounds() {
     return 0;
 }
 
-//++ Load all textures from "data/textures/" into textureMap
+//++ Load all textures from "data/textures/" into the texture store
 int loadTextures() {
     std::string textureFolderPath = path + dataFolder + "textures/";
 
@@ -176,7 +239,7 @@ int loadTextures() {
                 continue;
             }
 
-            textureMap[tempName] = tex;
+            textures.add(tempName, tempPath, tex);
             JFLX::log("Loaded Texture: ", (tempPath + " in " + tempName), JFLX::LOGTYPE::SUCCESS);
         }
     }
@@ -184,68 +247,48 @@ int loadTextures() {
     return 0;
 }
 
-//++ Play a sound effect by name
-void playSound(const std::string& soundName) {
-    //++ check if sound Exists
+//++ Looks up a sound effect, nullptr (logged) when it does not exist
+MIX_Audio* findSound(const std::string& soundName) {
     auto it = soundMap.find(soundName);
     if (it == soundMap.end()) {
         JFLX::log("Sound not found: ", soundName.c_str());
-        return;
+        return nullptr;
     }
-    MIX_Audio* audio = it->second;
+    return it->second;
+}
 
-    if (MIX_PlayAudio(soundMixer, audio)) {
-        JFLX::log("Played sound: ", soundName.c_str());
-    } else {
-        JFLX::log("MIX_PlayAudio failed: ", SDL_GetError());
+//++ Play a sound effect by name (UI / player), a full voice pool drops it when every voice is more important
+void playSound(const std::string& soundName, SOUNDPRIORITY priority = SOUNDPRIORITY::UI) {
+    if (MIX_Audio* sound = findSound(soundName)) {
+        audio.play(sound, priority);
     }
 }
 
-//++ Start a new music track, fading out the old one (helper)
-static void playMusic(std::string musicName) {
-    //++ If a track is already playing, fade it out and stop
-    if (musicTrack && MIX_TrackPlaying(musicTrack)) {
-        SDL_PropertiesID fadeout_opts = SDL_CreateProperties();
-        SDL_SetNumberProperty(fadeout_opts, MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER, 3000);
-        SDL_DestroyProperties(fadeout_opts);
+//++ Play a sound effect at a world position, attenuated and panned relative to the player
+void playSoundAt(const std::string& soundName, float x, float y, SOUNDPRIORITY priority = SOUNDPRIORITY::ENTITY) {
+    if (MIX_Audio* sound = findSound(soundName)) {
+        audio.playAt(sound, x, y, priority);
     }
+}
 
+//++ Crossfades to another music, nothing happens when it is already playing
+static void playMusic(const std::string& musicName) {
     //++ check if music Exists
     auto it = musicMap.find(musicName);
     if (it == musicMap.end()) {
         JFLX::log("Music not found: ", musicName.c_str());
         return;
     }
-    MIX_Audio* audio = it->second;
-
-    if (!musicTrack) {
-        JFLX::log("Music track not initialized", "", JFLX::LOGTYPE::ERROR);
-        return;
-    }
 
-    if (MIX_GetTrackAudio(musicTrack) == audio) {
-        JFLX::log("Already Playing Music: ", ("The Music Called to play was already playing [" + musicName + "]"), JFLX::LOGTYPE::INFO);
-        return;
+    if (audio.playMusic(it->second)) {
+        JFLX::log("Playing music: ", musicName, JFLX::LOGTYPE::SUCCESS);
     }
+}
 
-    //++ assign audio to track
-    MIX_SetTrackAudio(musicTrack, audio);
-
-    //++ Loop infinitely by default
-    SDL_PropertiesID options = SDL_CreateProperties();
-    SDL_SetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
-    SDL_SetNumberProperty(options, MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER, 2000);
-
-    if (MIX_PlayTrack(musicTrack, options)) {
-        if (MIX_TrackPlaying(musicTrack)) {
-            JFLX::log("Playing music: ", musicName, JFLX::LOGTYPE::SUCCESS);
-        } else {
-            JFLX::log("Track Not Playing: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
-        }
-    } else {
-        JFLX::log("MIX_PlayTrack failed: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
-    }
-    SDL_DestroyProperties(options);
+//++ Journal of the current level, recorded / replayed sessions use their own journals so they start from the generated world
+std::string journalPath() {
+    bool session = inputRecorder.recording() || inputReplay.loaded();
+    return path + dataFolder + (session ? "saves/replay/" : "saves/") + "level" + currentLevel + ".journal";
 }
 
 //++ Initialisation of a new game State
@@ -268,9 +311,35 @@ void initState() {
                 break;
             }
             case STATE::EXPLORING: {
-                playMusic(levelData[currentLevel]["theme"].get<std::string>());
+                const LevelConfig* level = levelData->find(currentLevel);
+                if (!level) {
+                    JFLX::log("Level: ", "No level data for level " + currentLevel, JFLX::LOGTYPE::ERROR);
+                    currentState = STATE::MAINMENU;
+                    return;
+                }
+
+                playMusic(level->theme);
                 // TODO: Exploring logic
-                currentTileMap = levelData[currentLevel]["tileset"].get<std::string>();
+                currentTileMap = level->tileset;
+
+                levelLoot.build(level->possibleItems);
+
+                //++ Saved changes of the level, applied to every chunk when it is created
+                journal.open(journalPath(), worldSeed);
+                chunkManager.onCreate = [](Chunk& c, int chunkX, int chunkY) {
+                    journal.apply(c, chunkX, chunkY, levelLoot);
+                };
+                for (auto& [key, chunk] : chunkManager.chunks) {
+                    journal.apply(chunk, int(int64_t(key) >> 32), int(uint32_t(key)), levelLoot);
+                }
+
+                //++ Entities of the chunks around the player
+                entities.clear();
+                for (int cy = worldToChunk(player.y) - 1; cy <= worldToChunk(player.y) + 1; ++cy) {
+                    for (int cx = worldToChunk(player.x) - 1; cx <= worldToChunk(player.x) + 1; ++cx) {
+                        spawnChunkEntities(entities, chunkManager, level->possibleEntities, cx, cy, worldSeed);
+                    }
+                }
 
                 break;
             }
@@ -283,38 +352,106 @@ void initState() {
     }
 }
 
-//++ Updates the mouse Scales if window size changed!
-void updateMouseScale() {
-    int currentWindowW, currentWindowH;
-    SDL_GetWindowSize(window, &currentWindowW, &currentWindowH);
+//++ Applies the render settings, the frame time target is the frame rate setting, at most the display refresh rate
+void updatePresentationSettings() {
+    presentation.quality           = settings.renderQuality;
+    presentation.dynamicResolution = settings.dynamicResolution && !launchOptions.measured();
 
-    if (currentWindowW != windowWidth || currentWindowH != windowHeight) {
-        //! Change to Log
-        // std::cout << "Window Resolution Was Changed! From: "
-        //           << widthOld << "," << heightOld
-        //           << "; To: "
-        //           << windowW << "," << windowH << "\n";
-        
-        float scaleX = static_cast<float>(currentWindowW) / 960.0f;
-        float scaleY = static_cast<float>(currentWindowH) / 540.0f;
-        scaleMousePositionFactorX = 2.0f / scaleX;
-        scaleMousePositionFactorY = 2.0f / scaleY;
-        
-        //! Change to Log
-        // std::cout << "New Scales: " << scaleX << "," << scaleY
-        //           << " for mouse: " << scaleXMouse << "," << scaleYMouse << "\n";
-        
-        windowWidth = currentWindowW;
-        windowHeight = currentWindowH;
-    }
+    float frameRate = float(settings.frameRate);
+    const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+    if (mode && mode->refresh_rate > 0.0f) frameRate = std::min(frameRate, mode->refresh_rate);
+    presentation.targetFrameMs = 1000.0f / std::max(frameRate, 1.0f);
 }
 
 //++ Updates the music and sound mixer gain based on the settings
 void updateMixerGain() {
     //++ Updating music Mixer Gain
-    MIX_SetMasterGain(musicMixer, settings["volume"]["music"].get<int>()/100.0f);
+    MIX_SetMasterGain(musicMixer, settings.musicVolume/100.0f);
     //++ Updating sound Mixer Gain
-    MIX_SetMasterGain(soundMixer, settings["volume"]["sfx"].get<int>()/100.0f);
+    MIX_SetMasterGain(soundMixer, settings.sfxVolume/100.0f);
+}
+
+//++ Screen of the current state, nullptr outside of menus
+UIScreen* activeScreen() {
+    switch (currentState) {
+        case STATE::TITLESCREEN: return &titleScreen;
+        case STATE::MAINMENU:    return &mainMenuScreen;
+        case STATE::SETTINGS:    return &settingsScreen;
+        default:                 return nullptr;
+    }
+}
+
+//++ Shows the current settings in the settings menu
+void updateSettingsScreen() {
+    settingsScreen.setValue(UIACTION::MUSICVOLUME, settings.musicVolume);
+    settingsScreen.setValue(UIACTION::SFXVOLUME, settings.sfxVolume);
+    settingsScreen.setValue(UIACTION::RENDERQUALITY, int(std::round(settings.renderQuality * 100.0f)));
+    settingsScreen.setValue(UIACTION::DYNAMICRESOLUTION, settings.dynamicResolution ? 1 : 0);
+}
+
+//++ Builds the widgets of all menus, values are taken from the settings
+void buildMenus() {
+    const float centerX = PRESENT_VIRTUALWIDTH / 2.0f;
+    const float width   = 800.0f;
+    const float height  = 96.0f;
+    auto row = [&](int index) {
+        return SDL_FRect{centerX - width / 2.0f, 320.0f + index * (height + UI_PADDING * 2.0f), width, height};
+    };
+
+    titleScreen.label(title, {0.0f, 160.0f, float(PRESENT_VIRTUALWIDTH), 128.0f});
+    titleScreen.button("Start", UIACTION::START, row(2));
+
+    mainMenuScreen.label("Main Menu", {0.0f, 160.0f, float(PRESENT_VIRTUALWIDTH), 128.0f});
+    mainMenuScreen.button("Play", UIACTION::PLAY, row(0));
+    mainMenuScreen.button("Settings", UIACTION::SETTINGS, row(1));
+    mainMenuScreen.button("Quit", UIACTION::QUIT, row(2));
+
+    settingsScreen.label("Settings", {0.0f, 160.0f, float(PRESENT_VIRTUALWIDTH), 128.0f});
+    settingsScreen.slider("Music", UIACTION::MUSICVOLUME, row(0), 0, 100, 5);
+    settingsScreen.slider("Sounds", UIACTION::SFXVOLUME, row(1), 0, 100, 5);
+    settingsScreen.slider("Render Quality", UIACTION::RENDERQUALITY, row(2), int(PRESENT_MINQUALITY * 100), 100, 5);
+    settingsScreen.toggle("Dynamic Resolution", UIACTION::DYNAMICRESOLUTION, row(3));
+    settingsScreen.button("Back", UIACTION::BACK, row(4));
+
+    updateSettingsScreen();
+}
+
+//++ Applies an event of a menu widget, settings are only touched when they changed
+void handleUIEvent(const UIEvent& uiEvent) {
+    switch (uiEvent.action) {
+        case UIACTION::START:    currentState = STATE::MAINMENU; break;
+        case UIACTION::PLAY:     currentState = STATE::EXPLORING; break;
+        case UIACTION::SETTINGS: currentState = STATE::SETTINGS; break;
+        case UIACTION::BACK:     currentState = STATE::MAINMENU; break;
+        case UIACTION::QUIT: {
+            SDL_Event quit{};
+            quit.type = SDL_EVENT_QUIT;
+            SDL_PushEvent(&quit);
+            break;
+        }
+        case UIACTION::MUSICVOLUME: {
+            settings.musicVolume = uiEvent.value;
+            updateMixerGain();
+            break;
+        }
+        case UIACTION::SFXVOLUME: {
+            settings.sfxVolume = uiEvent.value;
+            updateMixerGain();
+            break;
+        }
+        case UIACTION::RENDERQUALITY: {
+            settings.renderQuality = uiEvent.value / 100.0f;
+            updatePresentationSettings();
+            break;
+        }
+        case UIACTION::DYNAMICRESOLUTION: {
+            settings.dynamicResolution = uiEvent.value != 0;
+            updatePresentationSettings();
+            break;
+        }
+        default:
+            break;
+    }
 }
 
 //++ Update FrameMap
@@ -324,10 +461,70 @@ void updateFrameMap(float deltaTime) {
     }
 }
 
+//++ Moves the player with WASD, walls are resolved by movePlayer (tileCollision.hpp)
+void updatePlayer(float deltaTime) {
+    float dirX = float(input.down(SDL_SCANCODE_D)) - float(input.down(SDL_SCANCODE_A));
+    float dirY = float(input.down(SDL_SCANCODE_S)) - float(input.down(SDL_SCANCODE_W));
+
+    //-> Diagonal movement is not faster
+    float length = std::sqrt(dirX * dirX + dirY * dirY);
+    if (length > 0.0f) {
+        dirX /= length;
+        dirY /= length;
+    }
+
+    player.vx = dirX * player.speed;
+    player.vy = dirY * player.speed;
+    movePlayer(chunkManager, player, deltaTime);
+}
+
+//++ Swaps in config files that were changed on disk (parsed by the config watcher thread)
+void applyConfigChanges() {
+    if (std::shared_ptr<const SettingsConfig> changed = settingsSlot.take()) {
+        settings = *changed;
+        updateMixerGain();
+        updatePresentationSettings();
+        updateSettingsScreen();
+    }
+
+    if (std::shared_ptr<const LevelDataConfig> changed = levelDataSlot.take()) {
+        std::shared_ptr<const LevelDataConfig> previous = levelData;
+        levelData = changed;
+        if (currentState != STATE::EXPLORING) return;
+
+        //-> Running level: apply what can change without a restart
+        const LevelConfig* before = previous->find(currentLevel);
+        const LevelConfig* level  = levelData->find(currentLevel);
+        if (!level) {
+            JFLX::log("Level: ", "Reloaded level data has no level " + currentLevel + ", keeping the running level", JFLX::LOGTYPE::WARNING);
+            levelData = previous;
+            return;
+        }
+        if (!before || before->theme != level->theme) playMusic(level->theme);
+        if (currentTileMap != level->tileset) {
+            currentTileMap = level->tileset;
+            chunkManager.invalidateTextures();
+        }
+        levelLoot.build(level->possibleItems);
+    }
+}
+
 //++ Update function (game logic per frame)
 void update(float deltaTime) {
+    applyConfigChanges();
+
+    //-> Changed texture files: only chunks built with a changed tileset are rebuilt
+    for (TextureHandle changed : textures.update(renderer)) {
+        chunkManager.invalidateTileset(changed.index);
+    }
+
     //! JFLX::log("DeltaTime Update: ", std::to_string(deltaTime), JFLX::LOGTYPE::INFO);
     
+    for (const UIEvent& uiEvent : uiEvents) {
+        handleUIEvent(uiEvent);
+    }
+    uiEvents.clear();
+
     initState();
     updateFrameMap(deltaTime);
 
@@ -342,12 +539,25 @@ void update(float deltaTime) {
         }
         case STATE::SETTINGS: {
             // TODO: main menu logic
-            updateMixerGain();
             break;
         }
         case STATE::EXPLORING: {
             // TODO: Exploring logic
-            chunkManager.update(renderer, textureMap[currentTileMap]);
+            chunkManager.loadAround(worldToChunk(player.x + player.width * 0.5f), worldToChunk(player.y + player.height * 0.5f), CHUNKLOADRADIUS);
+            updatePlayer(deltaTime);
+
+            //-> Entity sounds are heard from the player
+            static std::vector<EntitySound> entitySounds;
+            entitySounds.clear();
+            updateEntities(entities, chunkManager, paths, player, deltaTime, entitySounds);
+            audio.setListener(player.x + player.width * 0.5f, player.y + player.height * 0.5f);
+            for (const EntitySound& sound : entitySounds) {
+                playSoundAt(std::string(entityTypeInfo(sound.type).sound), sound.x, sound.y);
+            }
+            TextureHandle tileset = textures.handle(currentTileMap);
+            chunkManager.update(renderer, textures.get(tileset), tileset.index);
+            paths.update(chunkManager);
+            lighting.update(renderer, chunkManager, player);
             break;
         }
         default: {
@@ -360,12 +570,11 @@ void update(float deltaTime) {
 //++ Draw a texture by name at given coordinates
 void drawTexture(const std::string& textureName, float x = 0, float y = 0, bool flipTexture = false) {
     //++ check if texture Exists
-    auto it = textureMap.find(textureName);
-    if (it == textureMap.end()) {
+    SDL_Texture* tex = textures.find(textureName);
+    if (!tex) {
         JFLX::log("Texture not found: ", textureName, JFLX::LOGTYPE::ERROR);
         return;
     }
-    SDL_Texture* tex = it->second;
 
     //++ try to get texture size
     float texW = 0, texH = 0;
@@ -374,17 +583,11 @@ void drawTexture(const std::string& textureName, float x = 0, float y = 0, bool
         return;
     }
 
-    //++ set render target to renderTexture
-    SDL_SetRenderTarget(renderer, renderTexture);
-
     //++ Destination rectangle using the Texture Size
     SDL_FRect dst = {x, y, texW, texH};
 
-    SDL_FlipMode flipOrientation = flipTexture ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-
-    if (!SDL_RenderTextureRotated(renderer, tex, nullptr, &dst, 0.0, nullptr, flipOrientation)) {
-        JFLX::log("SDL_RenderTexture failed: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
-    }
+    //-> Recorded only, the render target is set once when the queue is flushed
+    renderQueue.sprite(RENDERLAYER::UI, tex, nullptr, dst, flipTexture);
 }
 
 //++ Draw a Text at a given location | Orientations: -1 = left, 0 = center, 1 = right
@@ -396,23 +599,11 @@ void drawText(std::string text, int fontSize, float x = 0, float y = 0, Color co
 
     SDL_Color sdlColor = {color.c_r, color.c_g, color.c_b, color.c_a };
 
-    // Render text to a surface
-    SDL_Surface* surface = TTF_RenderText_Blended(fontPtr, text.c_str(), text.size(), sdlColor);
-    if (!surface) {
-        JFLX::log("Failed to render text: ", SDL_GetError(),  JFLX::LOGTYPE::ERROR);
-        return;
-    }
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_DestroySurface(surface);
+    //-> Texture of the text is kept in the cache while it is drawn
+    const CachedText* cachedText = textCache.get(renderer, fontPtr, text, sdlColor);
+    if (!cachedText) return;
 
-    if (!texture) {
-        JFLX::log("Failed to create text texture: ", SDL_GetError(),  JFLX::LOGTYPE::ERROR);
-        return;
-    }
-
-    float textW, textH;
-    SDL_GetTextureSize(texture, &textW, &textH);
+    float textW = cachedText->width, textH = cachedText->height;
 
     // Position based on orientation
     SDL_FRect dstRect;
@@ -427,11 +618,9 @@ void drawText(std::string text, int fontSize, float x = 0, float y = 0, Color co
 
     // Shadow first 
     if (outline) {
-        SDL_Surface* outlineSurface = TTF_RenderText_Blended(font, text.c_str(), text.size(), {0, 0, 0, 255});
-        SDL_Texture* outlineTexture = SDL_CreateTextureFromSurface(renderer, outlineSurface);
-        SDL_DestroySurface(outlineSurface);
+        const CachedText* outlineText = textCache.get(renderer, font, text, {0, 0, 0, 255});
 
-        if (outlineTexture) {
+        if (outlineText) {
             SDL_FRect outlineRect = dstRect;
 
             //++ Offset in relation der fontSize
@@ -447,39 +636,31 @@ void drawText(std::string text, int fontSize, float x = 0, float y = 0, Color co
             for (auto& o : offsets) {
                 outlineRect.x = dstRect.x + o.x;
                 outlineRect.y = dstRect.y + o.y;
-                SDL_RenderTexture(renderer, outlineTexture, nullptr, &outlineRect);
+                renderQueue.sprite(RENDERLAYER::UI, outlineText->texture, nullptr, outlineRect);
             }
-
-            SDL_DestroyTexture(outlineTexture);
         }
     }
 
 
     //++ Draw FG text
-    SDL_RenderTexture(renderer, texture, nullptr, &dstRect);
-
-    SDL_DestroyTexture(texture);
+    renderQueue.sprite(RENDERLAYER::UI, cachedText->texture, nullptr, dstRect);
 }
 
 //++ Render function (main drawing function for a frame)
 void render() {
     switch (currentState) {
-        case STATE::TITLESCREEN: {
-            // TODO: title screen logic
-            break;
-        }
-        case STATE::MAINMENU: {
-            // TODO: main menu logic
-            break;
-        }
+        case STATE::TITLESCREEN:
+        case STATE::MAINMENU:
         case STATE::SETTINGS: {
-            // TODO: main menu logic
-            updateMixerGain();
+            //-> Only the widgets that changed are redrawn, the rest is the cached screen
+            activeScreen()->render(renderer, renderQueue, textCache, font);
             break;
         }
         case STATE::EXPLORING: {
             // TODO: Exploring logic
-            chunkManager.render(renderer);
+            chunkManager.render(renderQueue);
+            renderEntities(renderQueue, entities, textures);
+            lighting.render(renderQueue);
             break;
         }
         default: {
@@ -494,8 +675,9 @@ void render() {
 }
 
 //* Handle keyboard input events
-void handleKeyboardInput(const SDL_KeyboardEvent& key) {
-    JFLX::log("Pressed: ", SDL_GetScancodeName(key.scancode), JFLX::LOGTYPE::INFO);
+void handleKeyboardInput(const InputEvent& key) {
+    SDL_Scancode scancode = SDL_Scancode(key.code);
+    JFLX::log("Pressed: ", SDL_GetScancodeName(scancode), JFLX::LOGTYPE::INFO);
 
     switch (currentState) {
         case STATE::TITLESCREEN: {
@@ -505,21 +687,21 @@ void handleKeyboardInput(const SDL_KeyboardEvent& key) {
         }
         case STATE::MAINMENU: {
             // TODO: main menu logic
-            if (key.key == SDLK_ESCAPE) {
+            if (scancode == SDL_SCANCODE_ESCAPE) {
                 currentState = STATE::TITLESCREEN;
             }
             break;
         }
         case STATE::SETTINGS: {
             // TODO: main menu logic
-            if (key.key == SDLK_ESCAPE) {
+            if (scancode == SDL_SCANCODE_ESCAPE) {
                 currentState = STATE::TITLESCREEN;
             }
             break;
         }
         case STATE::EXPLORING: {
             // TODO: Exploring logic
-            if (key.key == SDLK_ESCAPE) {
+            if (scancode == SDL_SCANCODE_ESCAPE) {
                 isPaused = !isPaused;
             }
             break;
@@ -531,33 +713,71 @@ void handleKeyboardInput(const SDL_KeyboardEvent& key) {
     }
 }
 
-//* Handle Mouse input events
-void handleMouseInput(const SDL_MouseButtonEvent& mouse) {
-    JFLX::log("Mouse button pressed: ", std::to_string(static_cast<int>(mouse.button)) + " at (" + std::to_string(mouse.x) + ", " + std::to_string(mouse.y) + ")", JFLX::LOGTYPE::INFO);
-
-    switch (currentState) {
-        case STATE::TITLESCREEN: {
-            // Title screen mouse logic
-            break;
+//++ Searches the first locker / shelf at or next to the player and moves its items into the inventory
+void searchNearbyTile() {
+    int playerTileX = worldToTile(player.x + player.width * 0.5f);
+    int playerTileY = worldToTile(player.y + player.height * 0.5f);
+
+    static constexpr int OFFSETS[5][2] = {{0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    for (const auto& offset : OFFSETS) {
+        int tileX = playerTileX + offset[0];
+        int tileY = playerTileY + offset[1];
+        int chunkX = tileToChunk(tileX);
+        int chunkY = tileToChunk(tileY);
+
+        Chunk* c = chunkManager.findChunk(chunkX, chunkY);
+        if (!c) continue;
+        uint8_t tile = tileIndex(tileToLocal(tileX), tileToLocal(tileY));
+        bool firstSearch = !c->interactables.wasSearched(tile);
+        SearchedTile* searched = searchTile(*c, chunkX, chunkY, tileToLocal(tileX), tileToLocal(tileY), worldSeed, levelLoot);
+        if (!searched) continue;
+        if (firstSearch) {
+            LOOTKIND kind = c->tiles[tileToLocal(tileY)][tileToLocal(tileX)].isLocker ? LOOTKIND::LOCKER : LOOTKIND::SHELF;
+            journal.recordSearch(chunkX, chunkY, tile, kind);
         }
 
-        case STATE::MAINMENU: {
-            if (mouse.button == SDL_BUTTON_LEFT) {
-                // Handle menu click
+        for (int slot = 0; slot < LOOT_SLOTS; ++slot) {
+            if (searched->items[slot] == uint16_t(objectIDs::EMPTY)) continue;
+
+            auto freeSlot = std::find(player.inventory.begin(), player.inventory.end(), objectIDs::EMPTY);
+            if (freeSlot == player.inventory.end()) {
+                JFLX::log("Inventory: ", "Full", JFLX::LOGTYPE::INFO);
+                return;
             }
-            break;
+            *freeSlot = objectIDs(c->interactables.take(searched->tile, slot));
+            journal.recordTake(chunkX, chunkY, searched->tile, slot);
+            JFLX::log("Inventory: ", "Picked up " + std::string(getObjectName(uint16_t(*freeSlot))), JFLX::LOGTYPE::INFO);
         }
+        return;
+    }
+}
 
+//* Handle mouse movement, only menus use it (hover)
+void handleMouseMotion(const InputEvent& motion) {
+    UIScreen* screen = activeScreen();
+    if (screen && screen->mouseMove({float(motion.x), float(motion.y)})) {
+        playSound("hover");
+    }
+}
+
+//* Handle Mouse input events
+void handleMouseInput(const InputEvent& mouse) {
+    SDL_FPoint mousePosition = {float(mouse.x), float(mouse.y)};
+    JFLX::log("Mouse button pressed: ", std::to_string(static_cast<int>(mouse.code)) + " at (" + std::to_string(mousePosition.x) + ", " + std::to_string(mousePosition.y) + ")", JFLX::LOGTYPE::INFO);
+
+    switch (currentState) {
+        case STATE::TITLESCREEN:
+        case STATE::MAINMENU:
         case STATE::SETTINGS: {
-            if (mouse.button == SDL_BUTTON_LEFT) {
-                // Handle settings click
+            if (mouse.code == SDL_BUTTON_LEFT) {
+                activeScreen()->mouseClick(mousePosition, uiEvents);
             }
             break;
         }
 
         case STATE::EXPLORING: {
-            if (mouse.button == SDL_BUTTON_RIGHT) {
-                // Example: interact / context action
+            if (mouse.code == SDL_BUTTON_RIGHT) {
+                searchNearbyTile();
             }
             break;
         }
@@ -567,8 +787,103 @@ void handleMouseInput(const SDL_MouseButtonEvent& mouse) {
     }
 }
 
+//++ SDL input event -> InputEvent (mouse in virtual coordinates), false for events the simulation does not use
+bool toInputEvent(const SDL_Event& event, InputEvent& inputEvent) {
+    inputEvent = {};
+    inputEvent.step = simStep;
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP: {
+            if (event.key.repeat) return false;
+            inputEvent.type = event.type == SDL_EVENT_KEY_DOWN ? INPUTTYPE::KEYDOWN : INPUTTYPE::KEYUP;
+            inputEvent.code = uint16_t(event.key.scancode);
+            return true;
+        }
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+        case SDL_EVENT_MOUSE_MOTION: {
+            //-> Window -> virtual coordinates (the space everything is drawn in), rounded like the recording
+            float x = event.type == SDL_EVENT_MOUSE_MOTION ? event.motion.x : event.button.x;
+            float y = event.type == SDL_EVENT_MOUSE_MOTION ? event.motion.y : event.button.y;
+            SDL_FPoint point = presentation.windowToVirtual(x, y);
+            inputEvent.type = event.type == SDL_EVENT_MOUSE_MOTION ? INPUTTYPE::MOUSEMOVE : INPUTTYPE::MOUSEUP;
+            inputEvent.code = event.type == SDL_EVENT_MOUSE_MOTION ? 0 : event.button.button;
+            inputEvent.x    = int16_t(std::clamp(std::lround(point.x), long(INT16_MIN), long(INT16_MAX)));
+            inputEvent.y    = int16_t(std::clamp(std::lround(point.y), long(INT16_MIN), long(INT16_MAX)));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+//++ Handles a live or replayed input event at the start of a step, live events are recorded
+void handleInputEvent(InputEvent inputEvent) {
+    inputEvent.step = simStep;
+    inputRecorder.add(inputEvent);
+    input.apply(inputEvent);
+
+    switch (inputEvent.type) {
+        case INPUTTYPE::KEYDOWN:   handleKeyboardInput(inputEvent); break;
+        case INPUTTYPE::MOUSEUP:   handleMouseInput(inputEvent); break;
+        case INPUTTYPE::MOUSEMOVE: handleMouseMotion(inputEvent); break;
+        default: break;
+    }
+}
+
+//++ Whole text as a number of at least minimum, logs the option otherwise
+bool parseIntArgument(const std::string& text, int& value, int minimum, const std::string& option) {
+    const char* first = text.data();
+    const char* last  = text.data() + text.size();
+    int parsed = 0;
+    auto [end, error] = std::from_chars(first, last, parsed);
+    if (error != std::errc() || end != last || parsed < minimum) {
+        JFLX::log("Arguments: ", "Invalid value for " + option + ": \"" + text + "\" is not a number of at least " + std::to_string(minimum), JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+//++ Reads the command line into launchOptions, false for unknown arguments and invalid values
+bool parseArguments(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--record" && hasValue) {
+            launchOptions.recordPath = argv[++i];
+        } else if (argument == "--replay" && hasValue) {
+            launchOptions.replayPath = argv[++i];
+        } else if (argument == "--profile" && hasValue) {
+            launchOptions.profilePath = argv[++i];
+        } else if (argument == "--headless") {
+            launchOptions.headless = true;
+        } else if (argument == "--benchmark" && hasValue) {
+            if (!parseIntArgument(argv[++i], launchOptions.benchmarkFrames, 1, argument)) return false;
+        } else if (argument == "--dump" && hasValue) {
+            launchOptions.dumpFolder = argv[++i];
+        } else if (argument == "--dumpEvery" && hasValue) {
+            if (!parseIntArgument(argv[++i], launchOptions.dumpEvery, 1, argument)) return false;
+        } else {
+            JFLX::log("Arguments: ", "Unknown argument " + argument + ", usage: [--record <file> | --replay <file> | --benchmark <frames> [--dump <folder>] [--dumpEvery <n>]] [--headless] [--profile <csv>]", JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+    }
+    int modes = int(!launchOptions.recordPath.empty()) + int(!launchOptions.replayPath.empty()) + int(launchOptions.benchmarkFrames > 0);
+    if (modes > 1) {
+        JFLX::log("Arguments: ", "--record, --replay and --benchmark can not be used together", JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    return true;
+}
+
 
 bool setup() {
+    //* Headless: no window / audio device is needed, frames are rendered by the software renderer
+    if (launchOptions.headless) {
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+    }
+
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO)) {
         JFLX::log("SDL_Init Error: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
         cleanUp();
@@ -583,16 +898,14 @@ bool setup() {
     }
 
     // create a renderer (index -1 = first, flags = accelerated+vsync recommended)
-    renderer = SDL_CreateRenderer(window, nullptr);
+    renderer = SDL_CreateRenderer(window, launchOptions.headless ? SDL_SOFTWARE_RENDERER : nullptr);
     if (!renderer) {
         JFLX::log("SDL_CreateRenderer failed: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
         cleanUp();
         return false;
     }
     
-    renderTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, virtualWidth, virtualHeight);
-    if (!renderTexture) {
-        JFLX::log("SDL_CreateTexture failed: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
+    if (!presentation.resize(renderer, window)) {
         cleanUp();
         return false;
     }
@@ -619,9 +932,7 @@ bool setup() {
         return false;
     }
 
-    musicTrack = MIX_CreateTrack(musicMixer);
-    if (!musicTrack) {
-        JFLX::log("MIX_CreateTrack failed: ", SDL_GetError(), JFLX::LOGTYPE::ERROR);
+    if (!audio.init(soundMixer, musicMixer)) {
         cleanUp();
         return false;
     }
@@ -641,22 +952,68 @@ bool setup() {
     }
     TTF_SetFontStyle(fontBold, TTF_STYLE_BOLD);
     
-    //* load config, assets and general set up calls
-    if (!JFLX::loadJson(path + "/data/config/settings.json", settings)) {
-        cleanUp();
-        return false;
+    //* load config, assets and general set up calls (missing / invalid config files keep the defaults)
+    loadConfig(settingsPath, settings, parseSettings);
+    loadConfig(progressPath, progress, parseProgress);
+    currentLevel = progress.currentLevel;
+    worldSeed    = progress.worldSeed;
+
+    //* Recorded / replayed sessions: same seed and level, path results in request order, own journals
+    if (!launchOptions.replayPath.empty()) {
+        if (!inputReplay.load(launchOptions.replayPath)) {
+            cleanUp();
+            return false;
+        }
+        if (inputReplay.session.stepMicroseconds != uint32_t(SIM_STEP * 1000000.0f)) {
+            JFLX::log("Input Replay: ", "Recorded with another step length, the replay will differ", JFLX::LOGTYPE::WARNING);
+        }
+        currentLevel = inputReplay.session.level;
+        worldSeed    = inputReplay.session.worldSeed;
+    }
+    if (!launchOptions.recordPath.empty() || !launchOptions.replayPath.empty()) {
+        std::error_code error;
+        fs::remove_all(path + dataFolder + "saves/replay/", error);
+        paths.synchronous = true;
     }
-    if (!JFLX::loadJson(path + "/data/stats/progress.json", progress)) {
+    if (!launchOptions.recordPath.empty() && !inputRecorder.start(launchOptions.recordPath, {uint32_t(SIM_STEP * 1000000.0f), worldSeed, currentLevel})) {
         cleanUp();
         return false;
     }
+
+    objectRegistry.load(path + dataFolder + "json/objects.jsonc");
+
+    LevelDataConfig loadedLevels;
+    if (loadConfig(levelDataPath, loadedLevels, parseLevelData)) {
+        levelData = std::make_shared<const LevelDataConfig>(std::move(loadedLevels));
+    }
+
+    //* Hot reload: parsed on the watcher thread, swapped in by applyConfigChanges()
+    configWatcher.watch(settingsPath, []() {
+        auto changed = std::make_shared<SettingsConfig>();
+        if (loadConfig(settingsPath, *changed, parseSettings)) settingsSlot.publish(changed);
+    });
+    configWatcher.watch(levelDataPath, []() {
+        auto changed = std::make_shared<LevelDataConfig>();
+        if (loadConfig(levelDataPath, *changed, parseLevelData)) levelDataSlot.publish(changed);
+    });
+    configWatcher.start();
+
     loadMusic();
     loadSounds();
     loadTextures();
+    textures.watch();
 
     SDL_SetHint(SDL_HINT_RENDER_VSYNC, "1");
 
+    //* Replays / benchmarks run as fast as possible, the profiler measures the work of a frame, not the display
+    if (launchOptions.measured()) {
+        SDL_SetRenderVSync(renderer, 0);
+        profiler.reserve(inputReplay.loaded() ? inputReplay.endStep() : size_t(launchOptions.benchmarkFrames));
+    }
+
+    updatePresentationSettings();
     updateMixerGain();
+    buildMenus();
     return true;
 }
 
@@ -664,20 +1021,29 @@ bool setup() {
 void cleanUp() {
     JFLX::log("Running CleanUp: ", "", JFLX::LOGTYPE::SUCCESS);
 
-    //* Save Json's
-    if (JFLX::saveJson((path+"/data/config/settings.json"), settings)) {
+    //* Stop reloading before the settings are written
+    configWatcher.stop();
+
+    //* End of a recorded session, frame times of the run
+    inputRecorder.finish(simStep);
+    if (profiler.size() > 0) {
+        profiler.report(inputReplay.loaded() ? "Replay " + launchOptions.replayPath : launchOptions.benchmarkFrames > 0 ? "Benchmark" : "Run");
+        if (!launchOptions.profilePath.empty()) profiler.writeCsv(launchOptions.profilePath);
+    }
+
+    //* Save Json's (a replay may have clicked the settings, they are not kept)
+    if (!inputReplay.loaded() && JFLX::saveJson(settingsPath, settingsToJson(settings))) {
         JFLX::log("Saved Json: ", "Successfully Saved Settings.json", JFLX::LOGTYPE::SUCCESS);
     }
 
     //* Cleanup textures
-    for (auto& [name, tex] : textureMap) {
-        SDL_DestroyTexture(tex);
-    }    
-    textureMap.clear();
+    textures.clear();
 
-    //* Cleanup music track and musicMixer
-    for (auto& [name, audio] : soundMap) {
-        MIX_DestroyAudio(audio);
+    //* Cleanup voices / music tracks, audio and mixers
+    audio.destroy();
+
+    for (auto& [name, sound] : soundMap) {
+        MIX_DestroyAudio(sound);
     }
 
     soundMap.clear();
@@ -686,9 +1052,9 @@ void cleanUp() {
     }
     musicMap.clear();
 
-    if (musicTrack) {
-        MIX_DestroyTrack(musicTrack);
-        musicTrack = nullptr;
+    if (soundMixer) {
+        MIX_DestroyMixer(soundMixer);
+        soundMixer = nullptr;
     }
 
     if (musicMixer) {
@@ -696,13 +1062,25 @@ void cleanUp() {
         musicMixer = nullptr;
     }
 
+    //* Write the rest of the world journal
+    journal.close();
+
+    //* Cleanup light texture (the worker thread stops with the program)
+    lighting.destroy();
+
+    //* Cleanup cached text and menu textures (before the renderer is destroyed)
+    textCache.clear();
+    titleScreen.destroy();
+    mainMenuScreen.destroy();
+    settingsScreen.destroy();
+
     //* Cleanup Fonts
     TTF_CloseFont(font);
     TTF_CloseFont(fontBold);
 
 
     //* Destroy rendering objects and quit SDL subsystems
-    if (renderTexture) SDL_DestroyTexture(renderTexture);
+    presentation.destroy();
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
 
@@ -711,17 +1089,126 @@ void cleanUp() {
     SDL_Quit();
 }
 
+//++ A menu is idle when none of its widgets changed and no frame was requested
+bool menuIdle(bool frameRequested) {
+    UIScreen* screen = activeScreen();
+    return screen && screen->idle() && lastState == currentState && uiEvents.empty() && !frameRequested
+        && pendingInput.empty() && !inputReplay.loaded()
+        && !settingsSlot.pending() && !levelDataSlot.pending() && !textures.pending();
+}
+
+/*
+++ Render benchmark (--benchmark <frames>)
+The camera flies the path of renderBenchmark.hpp through a world with walls from the seed, only chunks and light are drawn.
+Light is cast on the main thread so a frame (and a dumped PNG) only depends on its number.
+*/
+int runBenchmark() {
+    const LevelConfig* level = levelData->find(currentLevel);
+    if (level) currentTileMap = level->tileset;
+    TextureHandle tileset = textures.handle(currentTileMap);
+
+    chunkManager.onCreate = [](Chunk& c, int chunkX, int chunkY) {
+        benchmarkChunk(c, chunkX, chunkY, worldSeed);
+    };
+    lighting.synchronous = true;
+
+    if (!launchOptions.dumpFolder.empty()) {
+        std::error_code error;
+        fs::create_directories(launchOptions.dumpFolder, error);
+    }
+
+    BenchmarkStats stats;
+    size_t storeBytes = textures.textureBytes();
+    JFLX::log("Benchmark: ", "Rendering " + std::to_string(launchOptions.benchmarkFrames) + " frames", JFLX::LOGTYPE::INFO);
+
+    SDL_Event event;
+    for (int frame = 0; frame < launchOptions.benchmarkFrames; ++frame) {
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_EVENT_QUIT) return 0;
+        }
+
+        uint64_t frameStart = SDL_GetTicksNS();
+        if (!presentation.resize(renderer, window)) return 1;
+
+        //-> Chunks around the view are loaded, the rest is unloaded (the lighting follows the camera like the player)
+        SDL_FPoint center = benchmarkCamera(frame * BENCH_STEP);
+        SDL_FRect view = {center.x - PRESENT_VIRTUALWIDTH * 0.5f, center.y - PRESENT_VIRTUALHEIGHT * 0.5f, float(PRESENT_VIRTUALWIDTH), float(PRESENT_VIRTUALHEIGHT)};
+        int minChunkX = worldToChunk(view.x) - BENCH_KEEPCHUNKS, maxChunkX = worldToChunk(view.x + view.w) + BENCH_KEEPCHUNKS;
+        int minChunkY = worldToChunk(view.y) - BENCH_KEEPCHUNKS, maxChunkY = worldToChunk(view.y + view.h) + BENCH_KEEPCHUNKS;
+        chunkManager.unloadOutside(minChunkX, minChunkY, maxChunkX, maxChunkY);
+        for (int cy = minChunkY; cy <= maxChunkY; ++cy) {
+            for (int cx = minChunkX; cx <= maxChunkX; ++cx) {
+                chunkManager.getChunk(cx, cy);
+            }
+        }
+        player.x = center.x - player.width * 0.5f;
+        player.y = center.y - player.height * 0.5f;
+
+        uint64_t rebuildsBefore = chunkManager.rebuilds;
+        chunkManager.update(renderer, textures.get(tileset), tileset.index);
+        lighting.update(renderer, chunkManager, player);
+        uint64_t updateEnd = SDL_GetTicksNS();
+
+        SDL_SetRenderTarget(renderer, presentation.target);
+        SDL_SetRenderDrawColor(renderer, 20, 20, 80, 255);
+        SDL_RenderClear(renderer);
+
+        chunkManager.render(renderQueue, &view);
+        lighting.render(renderQueue, view.x, view.y);
+        renderQueue.flush(renderer, presentation.target, presentation.renderScale());
+
+        presentation.present(renderer);
+        SDL_RenderPresent(renderer);
+
+        uint64_t frameEnd = SDL_GetTicksNS();
+        profiler.add({(frameEnd - frameStart) / 1000000.0f, (updateEnd - frameStart) / 1000000.0f, (frameEnd - updateEnd) / 1000000.0f});
+
+        //-> Texture memory: chunk textures, the frame and the loaded textures
+        size_t bytes = storeBytes + textureBytes(presentation.target);
+        for (auto& [key, chunk] : chunkManager.chunks) {
+            bytes += textureBytes(chunk.texture);
+        }
+        stats.frame(renderQueue.lastFrame, size_t(chunkManager.rebuilds - rebuildsBefore), chunkManager.chunks.size(), bytes);
+
+        if (!launchOptions.dumpFolder.empty() && frame % launchOptions.dumpEvery == 0) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame_%06d.png", frame);
+            saveFramePNG(renderer, presentation.target, presentation.frame(), (fs::path(launchOptions.dumpFolder) / name).string());
+        }
+    }
+
+    stats.report();
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
-    if (!setup()) {
+    if (!parseArguments(argc, argv) || !setup()) {
         return 1;
     }
 
+    if (launchOptions.benchmarkFrames > 0) {
+        int result = runBenchmark();
+        cleanUp();
+        return result;
+    }
+
     SDL_Event event;
     bool running    = true;
-    uint64_t lastTicks   = SDL_GetTicks();
+    uint64_t lastTicks   = SDL_GetTicksNS();
+    float stepTime       = 0.0f;   // seconds not simulated yet
+    bool frameRequested  = true;   // window contents were lost / changed outside of the game
 
     while (running) {
-        updateMouseScale();
+        //* Idle menus wait for input instead of drawing the same frame again
+        if (menuIdle(frameRequested)) {
+            SDL_WaitEventTimeout(nullptr, UI_IDLEWAITMS);
+        }
+
+        uint64_t frameStart = SDL_GetTicksNS();
+        if (!presentation.resize(renderer, window)) {
+            cleanUp();
+            return 1;
+        }
 
         while (SDL_PollEvent(&event)) {
             switch (event.type) {
@@ -729,50 +1216,91 @@ int main(int argc, char* argv[]) {
                     cleanUp();
                     return 0;
                 }
-                case SDL_EVENT_KEY_DOWN: {
-                    handleKeyboardInput(event.key);
+                case SDL_EVENT_WINDOW_EXPOSED:
+                case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED: {
+                    frameRequested = true;
+                    break;
+                }
+                case SDL_EVENT_RENDER_TARGETS_RESET: {
+                    //-> Contents of all render target textures are lost
+                    titleScreen.invalidate();
+                    mainMenuScreen.invalidate();
+                    settingsScreen.invalidate();
+                    chunkManager.invalidateTextures();
+                    frameRequested = true;
                     break;
                 }
-                case SDL_EVENT_MOUSE_BUTTON_UP: {
-                    handleMouseInput(event.button);
+                default: {
+                    //-> Input waits for the next step, a replay only takes the recorded input
+                    InputEvent inputEvent;
+                    if (!inputReplay.loaded() && toInputEvent(event, inputEvent)) {
+                        pendingInput.push_back(inputEvent);
+                    }
                     break;
                 }
             }
         }
 
-        uint64_t currentTicks = SDL_GetTicks();
-        float deltaTime = (currentTicks - lastTicks) / 1000.0f;
-        lastTicks = currentTicks;
+        //* Nothing changed on an idle menu: keep the presented frame
+        if (menuIdle(frameRequested)) {
+            lastTicks = SDL_GetTicksNS();
+            continue;
+        }
+        frameRequested = false;
 
-        update(deltaTime);
+        //* Fixed steps: a frame runs the steps its time covers, a replay runs one step per frame
+        uint64_t updateStart = SDL_GetTicksNS();
+        stepTime += (updateStart - lastTicks) / 1000000000.0f;
+        lastTicks = updateStart;
 
-        //* Render to the renderTexture
-        SDL_SetRenderTarget(renderer, renderTexture);
-        SDL_SetRenderDrawColor(renderer, 20, 20, 80, 255);
-        SDL_RenderClear(renderer);
+        int steps = inputReplay.loaded() ? 1 : std::min(int(stepTime / SIM_STEP), SIM_MAXSTEPS);
+        stepTime  = inputReplay.loaded() ? 0.0f : std::min(stepTime - steps * SIM_STEP, SIM_STEP);
+
+        for (int i = 0; i < steps; ++i) {
+            inputReplay.take(simStep, pendingInput);
+            for (const InputEvent& inputEvent : pendingInput) {
+                handleInputEvent(inputEvent);
+            }
+            pendingInput.clear();
 
-        if (!isPaused) {
-            update(deltaTime);
+            //-> Paused: no time passes, menus and reloads still run
+            update(isPaused ? 0.0f : SIM_STEP);
+            ++simStep;
         }
 
-        render();
+        //* Voices follow the listener once per frame, not once per step (every voice query locks the mixer)
+        audio.update();
+        uint64_t updateEnd = SDL_GetTicksNS();
 
-        //* Scale RenderTexture to window
-        SDL_SetRenderTarget(renderer, nullptr);
+        //* Render to the presentation texture
+        SDL_SetRenderTarget(renderer, presentation.target);
+        SDL_SetRenderDrawColor(renderer, 20, 20, 80, 255);
+        SDL_RenderClear(renderer);
 
-        int winW, winH;
-        SDL_GetWindowSize(window, &winW, &winH);
-        SDL_FRect dstRect = {0, 0, (float)winW, (float)winH};
+        render();
 
-        //* clear window to black before drawing
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+        //* Submit everything render() recorded
+        renderQueue.flush(renderer, presentation.target, presentation.renderScale());
+        textCache.endFrame();
 
-        //* Render the offscreen texture to the window
-        SDL_RenderTexture(renderer, renderTexture, nullptr, &dstRect);
+        //* Scale the frame to the window (letterboxed)
+        presentation.present(renderer);
 
         SDL_RenderPresent(renderer);
 
+        //* Dynamic resolution follows the time of the whole frame
+        uint64_t frameEnd = SDL_GetTicksNS();
+        float frameMs = (frameEnd - frameStart) / 1000000.0f;
+        presentation.frameTime(frameMs);
+
+        if (inputReplay.loaded() || !launchOptions.profilePath.empty()) {
+            profiler.add({frameMs, (updateEnd - updateStart) / 1000000.0f, (frameEnd - updateEnd) / 1000000.0f});
+        }
+
+        if (inputReplay.finished(simStep)) {
+            JFLX::log("Input Replay: ", "Finished after " + std::to_string(simStep) + " steps", JFLX::LOGTYPE::SUCCESS);
+            running = false;
+        }
     }
 
     cleanUp();
@@ -1,855 +1,1167 @@
-//_ CRUSADIA - World Generation CPP FILE _//_ COPYRIGHT (C) 2024 JFLX STUDIO - ALL RIGHTS RESERVED _//
-
-#include <iostream>
-#include <cstdint>
-#include <fstream>
-#include <filesystem>
-#include <unordered_map>
-#include <string>
-#include <memory>
-#include <cmath>
-#include <algorithm>
-
-#include <JFLX/logging.hpp>
-#include <JFLX/perlinNoise.hpp>
-
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <STB/stb_image_write.h>
-
-#include "tiles.hpp"
-#include "colorStruct.hpp"
-
-namespace fs = std::filesystem;
-
-std::string path = fs::current_path().string() + "/";
-
-std::vector<std::array<int, 2>> treeSeedsToProcess = {};
-
-void generateAndSaveNoisePreviewImage(int* perlinNoiseMap, std::string imageName, int sizeX, int sizeY, const std::string& worldName) {
-    uint8_t* img = new uint8_t[sizeX * sizeY * 3];
-
-    for (int i = 0; i < sizeX * sizeY; ++i) {
-        int v = perlinNoiseMap[i];
-
-        // if your noise is (-1..1), convert:
-        // int g = int((v + 1.0f) * 0.5f * 255);
-        // If already 0..255:
-        int g = std::clamp(v, 0, 255);
-
-        img[i * 3 + 0] = g;
-        img[i * 3 + 1] = g;
-        img[i * 3 + 2] = g;
-    }
-
-    std::string pngPath = path + "/worlds/" + worldName + "/worldData/" + imageName + "Preview.png";
-    if (!stbi_write_png(pngPath.c_str(), sizeX, sizeY, 3, img, sizeX * 3)) {
-        JFLX::log("World Generation: ", "Failed to save PNG!", JFLX::LOGTYPE::ERROR);
-    } else {
-        JFLX::log("World Generation: ", "Saved " + imageName + " preview image (.png)", JFLX::LOGTYPE::SUCCESS);
-    }
-}
-
-void generateAndSaveTilePreviewImage(Tile* tileMap, int sizeX, int sizeY, const std::string& worldName) {
-    uint8_t* img = new uint8_t[sizeX * sizeY * 3];
-
-    for (int i = 0; i < sizeX * sizeY; ++i) {
-        Tile t = tileMap[i];
-        if (t.blockID == TILES::BLOCKS::ID::AIR) {
-            img[i * 3 + 0] = std::clamp((TILES::COLORVALUES::COLORS[static_cast<uint16_t>(t.wallID)].c_r - 25), 0, 255);;
-            img[i * 3 + 1] = std::clamp((TILES::COLORVALUES::COLORS[static_cast<uint16_t>(t.wallID)].c_g - 25), 0, 255);;
-            img[i * 3 + 2] = std::clamp((TILES::COLORVALUES::COLORS[static_cast<uint16_t>(t.wallID)].c_b - 25), 0, 255);;
-            continue;
-        } else {
-            img[i * 3 + 0] = TILES::COLORVALUES::COLORS[static_cast<uint16_t>(t.blockID)].c_r;
-            img[i * 3 + 1] = TILES::COLORVALUES::COLORS[static_cast<uint16_t>(t.blockID)].c_g;
-            img[i * 3 + 2] = TILES::COLORVALUES::COLORS[static_cast<uint16_t>(t.blockID)].c_b;
-            continue;
-        }
-    }
-
-    std::string pngPath = path + "/worlds/" + worldName + "/worldData/tilePreview.png";
-    if (!stbi_write_png(pngPath.c_str(), sizeX, sizeY, 3, img, sizeX * 3)) {
-        JFLX::log("World Generation: ", "Failed to save PNG!", JFLX::LOGTYPE::ERROR);
-    } else {
-        JFLX::log("World Generation: ", "Saved tileMap preview image (.png)", JFLX::LOGTYPE::SUCCESS);
-    }
-}
-
-void fillAreaRecursion(Tile* tileMap, int* noiseMap, int targetX, int targetY, int limitMin, int limitMax, int sizeX, int sizeY, TILES::BLOCKS::ID blockID, TILES::WALLS::ID wallID = TILES::WALLS::ID::NOCHANGE, bool replaceAir = false, bool airWithWalls = true, std::array<bool,4> directions = {true, true, true, true}) {
-    if (targetX < 0 || targetX >= sizeX || targetY < 0 || targetY >= sizeY) {
-        return;
-    }
-
-    int index = targetY * sizeX + targetX;
-    TILES::BLOCKS::ID targetBlockID = tileMap[index].blockID;
-    TILES::WALLS::ID targetWallID = tileMap[index].wallID;
-    int noiseValue = noiseMap[index];
-
-
-    if ((noiseValue < limitMin) || (noiseValue > limitMax)) {
-        return;
-    }
-
-    if (!replaceAir && targetBlockID == TILES::BLOCKS::ID::AIR || replaceAir && airWithWalls && targetWallID == wallID || targetBlockID == blockID) {
-        return;
-    }
-
-    if (replaceAir) {
-        if (airWithWalls) {
-            if (targetBlockID == TILES::BLOCKS::ID::AIR) {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::NOCHANGE, wallID);
-            } else {
-                setTileIDS(tileMap[index], blockID);
-            }
-        } else {
-            setTileIDS(tileMap[index], blockID);
-        }
-    } else {
-        setTileIDS(tileMap[index], blockID);
-    }
-
-    // Recursively fill neighboring tiles
-    if (directions[2]) {fillAreaRecursion(tileMap, noiseMap, targetX + 1, targetY, limitMin, limitMax, sizeX, sizeY, blockID, wallID, replaceAir, airWithWalls, directions);} // Right
-    if (directions[1]) {fillAreaRecursion(tileMap, noiseMap, targetX - 1, targetY, limitMin, limitMax, sizeX, sizeY, blockID, wallID, replaceAir, airWithWalls, directions);} // Left
-    if (directions[3]) {fillAreaRecursion(tileMap, noiseMap, targetX, targetY + 1, limitMin, limitMax, sizeX, sizeY, blockID, wallID, replaceAir, airWithWalls, directions);} // Down
-    if (directions[0]) {fillAreaRecursion(tileMap, noiseMap, targetX, targetY - 1, limitMin, limitMax, sizeX, sizeY, blockID, wallID, replaceAir, airWithWalls, directions);} // Up
-}
-
-/*
-++ Flood Fill Algorithm to fill areas based on noise values
-
-Directions array:
-[0] = Up
-[1] = Left
-[2] = Right
-[3] = Down
-
-!! Filling Caves with water should only go down, left and right, not up.!!
-*/
-void fillArea(Tile* tileMap, int* noiseMap, int targetX, int targetY, int limitMin, int limitMax, int sizeX, int sizeY, TILES::BLOCKS::ID blockID, TILES::WALLS::ID wallID = TILES::WALLS::ID::NOCHANGE, bool replaceAir = false, bool airWithWalls = true, std::array<bool,4> directions = {true, true, true, true}) {
-    fillAreaRecursion(tileMap, noiseMap, targetX, targetY, limitMin, limitMax, sizeX, sizeY, blockID, wallID, replaceAir, airWithWalls, directions);
-}
-
-void fillCircularAreaFillCall(Tile* tileMap, int targetX, int targetY, int sizeX, int sizeY, std::unordered_map<TILES::BLOCKS::ID, TILES::TileArray>* replaceMapBlock, std::unordered_map<TILES::WALLS::ID, TILES::TileArray>* replaceMapWall) {
-    if (targetX < 0 || targetX >= sizeX || targetY < 0 || targetY >= sizeY) {
-        return;
-    }
-
-    int index = targetY * sizeX + targetX;
-    TILES::BLOCKS::ID targetBlockID = tileMap[index].blockID;
-    TILES::WALLS::ID targetWallID = tileMap[index].wallID;
-
-    if (targetBlockID == TILES::BLOCKS::ID::AIR && targetWallID == TILES::WALLS::ID::AIR) {
-        return;
-    }
-
-    if (replaceMapBlock->find(targetBlockID) != replaceMapBlock->end()) {
-        TILES::BLOCKS::ID blockID = replaceMapBlock->at(targetBlockID).block;
-        TILES::WALLS::ID wallID = replaceMapBlock->at(targetBlockID).wall; 
-        setTileIDS(tileMap[index], blockID, wallID);
-    } else if (replaceMapWall->find(targetWallID) != replaceMapWall->end()) {
-        TILES::BLOCKS::ID blockID = replaceMapWall->at(targetWallID).block; 
-        TILES::WALLS::ID wallID = replaceMapWall->at(targetWallID).wall; 
-        setTileIDS(tileMap[index], blockID, wallID);
-    }
-}
-
-/*
-? No longer used yet still helpful Full Explanation of the Midpoint Circle Algorithm: https://www.youtube.com/watch?v=hpiILbMkF9w
-*/
-void fillCircularArea(Tile* tileMap, int centerX, int centerY, int radius, int sizeX, int sizeY, std::unordered_map<TILES::BLOCKS::ID, TILES::TileArray>* replaceMapBlock, std::unordered_map<TILES::WALLS::ID, TILES::TileArray>* replaceMapWall) {
-    int r2 = radius * radius;
-
-    for (int y = -radius; y <= radius; ++y) {
-        int y2 = y * y;
-
-        for (int x = -radius; x <= radius; ++x) {
-            if (x*x + y2 <= r2) {
-                fillCircularAreaFillCall(tileMap, centerX + x, centerY + y, sizeX, sizeY, replaceMapBlock, replaceMapWall);
-            }
-        }
-    }
-}
-
-void setLayerAt(int x, int y, Tile* tileMap, int* noiseMapA, int* noiseMapB, int sizeX, int sizeY, int index) { //! Maybe Use 2nd map for the rock choices !!!
-    int noiseValueA = noiseMapA[y * sizeX + x];
-    int noiseValueB = noiseMapB[y * sizeX + x];
-
-    int percent = (y * 100) / sizeY;
-
-    //++ Height Distribution: noiseValue < Value = Air/Block, noiseValue >= Value = Wall
-    switch (percent) {
-        case 0 ... 5: { //++ space Layer
-            setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::AIR);
-            break;
-        }
-        case 6 ... 15: { //++ sky Layer
-            setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::AIR);
-            break;
-        }
-        case 16 ... 20: { //++ surface Layer
-            if (noiseValueA < 155) {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::DIRT, TILES::WALLS::ID::DIRT);
-            } else {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::DIRT);
-            }
-            break;
-        }
-        case 21 ... 25: { //++ ground Layer
-            if (noiseValueA < 143) {
-                if (noiseValueB < 80) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::CHALK, TILES::WALLS::ID::CHALK);
-                } else if (noiseValueB < 110) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::LIMESTONE, TILES::WALLS::ID::LIMESTONE);
-                } else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::SHALE, TILES::WALLS::ID::SHALE);
-                }
-            } else {
-                if (noiseValueB < 80) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::CHALK);
-                } else if (noiseValueB < 110) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::LIMESTONE);
-                } else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::SHALE);
-                }
-            }
-            break;
-        }
-        case 26 ... 35: { //++ caves Layer
-            if (noiseValueA < 143) {
-                if (noiseValueB < 80) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::GRANITE, TILES::WALLS::ID::GRANITE);
-                } else if (noiseValueB < 100) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::DIORITE, TILES::WALLS::ID::DIORITE);
-                } else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::ANDESITE, TILES::WALLS::ID::ANDESITE);
-                }
-            } else {
-                if (noiseValueB < 80) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::GRANITE);
-                } else if (noiseValueB < 100) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::DIORITE);
-                } else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::ANDESITE);
-                }
-            }
-            break;
-        }
-        case 36 ... 50: { //++ deep Caves Layer
-            if (noiseValueA < 143) {
-                if (noiseValueB < 70) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::SERPENTINITE, TILES::WALLS::ID::SERPENTINITE);
-                } else if (noiseValueB < 90) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::MARBLE, TILES::WALLS::ID::MARBLE);
-                } else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::SLATE, TILES::WALLS::ID::SLATE);
-                }
-            } else {
-                if (noiseValueB < 70) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::SERPENTINITE);
-                } else if (noiseValueB < 90) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::MARBLE);
-                } else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::SLATE);
-                }
-            }
-            break;
-        }
-        case 51 ... 68: { //++ Compression Layer
-            if (noiseValueA < 143) {
-                if (noiseValueB < 95) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::QUARTZITE, TILES::WALLS::ID::QUARTZITE);
-                }  else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::GNEISS, TILES::WALLS::ID::GNEISS);
-                }
-            } else {
-                if (noiseValueB < 95) {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::QUARTZITE);
-                }  else {
-                    setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::GNEISS);
-                }
-            }
-            break;
-        }
-        case 69 ... 73: { //++ outer Core Layer
-            if (noiseValueA < 143) {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::BASALT, TILES::WALLS::ID::BASALT);
-            } else {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::BASALT);
-            }
-            break;
-        }
-        case 74 ... 88: {//++ inner Core Layer
-            if (noiseValueA < 143) {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::KIMBERLITE, TILES::WALLS::ID::KIMBERLITE);
-            } else {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::KIMBERLITE);
-            }
-            break;
-        }
-        case 89 ... 101: { //++ bedrock Layer
-            if (noiseValueA < 143) {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::KIMBERLITE, TILES::WALLS::ID::KIMBERLITE);
-            } else {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::KIMBERLITE);
-            }
-            break;
-        }
-        default: {
-            setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::AIR);
-            break;
-        }
-    }
-}
-
-void setTilesByLayer(Tile* tileMap, int* noiseMapA, int* noiseMapB, int sizeX, int sizeY) {
-
-    for (int y = 0; y < sizeY; ++y) {
-        for (int x = 0; x < sizeX; ++x) {
-            int index = y * sizeX + x;
-            setLayerAt(x, y, tileMap, noiseMapA, noiseMapB, sizeX, sizeY, index);
-        }
-    }
-}
-
-/*
-++ Complex Wave Function for surfacelevel variation
-*/
-double complexWave(double x) {
-    // first part
-    double part1 = (1.0 + 0.33 * sin(2.0 * x)) * sin(x + 0.5 * sin(M_PI * x)) + 0.6 * sin(M_E * x) + 0.25 * sin(pow(x, 1.33));
-
-    // envelope/multiplier
-    double envelope = -2.0 + 0.2 * sin(M_PI * x) + 0.3 * sin(0.05 * x * x);
-
-    // final result
-    return part1 - envelope * part1 - M_PI;
-}
-
-void addTreeSeed(Tile* tileMap, int x, int y, int sizeX, int sizeY) {
-    if (y+1 > sizeY) {
-        return;
-    }
-    if (tileMap[(y+1) * sizeX + x].blockID != TILES::BLOCKS::ID::AIR) {
-        if ((rand() % 5) == 1) {
-            setTileIDS(tileMap[y * sizeX + x], TILES::BLOCKS::ID::TREESEED);
-            treeSeedsToProcess.push_back({x, y});
-        }
-    }
-}
-
-void generateSurfaceLevel(Tile* tileMap, int sizeX, int sizeY) {
-    for (int x = 0; x < sizeX; ++x) {
-        double limit = sizeY*0.16;
-        // Compute the target height for this column
-        int targetHeight = 10+static_cast<int>(limit - 2.5*complexWave(x * 0.05));
-
-        for (int y = targetHeight; y > 0; --y) {
-            setTileIDS(tileMap[y * sizeX + x], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::AIR);
-        }
-
-        addTreeSeed(tileMap, x, targetHeight, sizeX, sizeY);
-        
-        for (int i = 1; i <= 1 + (rand() % 4); ++i) {
-            int index = (targetHeight + i) * sizeX + x;
-            if (tileMap[index].blockID != TILES::BLOCKS::ID::AIR) {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::GRASS, TILES::WALLS::ID::GRASS);
-            } else {
-                setTileIDS(tileMap[index], TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::GRASS);
-            }
-        }
-    }
-}
-
-void generateBedrockLevel(Tile* tileMap, int sizeX, int sizeY) {
-    for (int x = 0; x < sizeX; ++x) {
-        double limit = sizeY*0.98;
-        // Compute the target height for this column
-        int targetHeight = static_cast<int>(limit + complexWave(x));
-
-        for (int y = sizeY - 1; y > targetHeight; --y) {
-            setTileIDS(tileMap[y * sizeX + x], TILES::BLOCKS::ID::BEDROCK, TILES::WALLS::ID::BEDROCK);
-        }
-    }
-}
-
-void decideOreAt(int x, int y, Tile* tileMap, int* noiseMap, int sizeX, int sizeY, int index) {
-    int noiseValue = noiseMap[index];
-    TILES::BLOCKS::ID currentBlockID = tileMap[index].blockID;
-    
-    int limitMin = 0;
-    int limitMax = 75;
-
-    if (noiseValue > limitMax || noiseValue < limitMin || currentBlockID == TILES::BLOCKS::ID::AIR) {
-        return;
-    }
-
-    //++ Getting Height For Layer Determination
-    int percent = (y * 100) / sizeY;
-
-    //++ Decide if ore or gems are choosen
-    int isOre = rand() % 12;
-    if (isOre > 2) {
-        int oreChoice = rand() % 100;
-
-        switch (percent) {
-            case 0 ... 5: {   //++ space Layer
-                break;
-            }
-            case 6 ... 16: {   //++ sky Layer
-                break;
-            }
-            case 17 ... 20: { //++ surface Layer
-                if (currentBlockID == TILES::BLOCKS::ID::GRASS || currentBlockID == TILES::BLOCKS::ID::DIRT) {
-                    if (oreChoice <= 33) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 30), sizeX, sizeY, TILES::BLOCKS::ID::MUD, TILES::WALLS::ID::MUD, true);
-                    } else if (oreChoice <= 66) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 20), sizeX, sizeY, TILES::BLOCKS::ID::GRAVEL, TILES::WALLS::ID::GRAVEL, true);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 40), sizeX, sizeY, TILES::BLOCKS::ID::CLAY, TILES::WALLS::ID::CLAY, true);
-                    }
-                }
-                break;
-            }
-            case 21 ... 25: {  //++ ground Layer
-                if (currentBlockID == TILES::BLOCKS::ID::CHALK || currentBlockID == TILES::BLOCKS::ID::SHALE || currentBlockID == TILES::BLOCKS::ID::LIMESTONE) {
-                    if (oreChoice <= 70) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 30), sizeX, sizeY, TILES::BLOCKS::ID::COAL);
-                    } else if (oreChoice <= 95) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 20), sizeX, sizeY, TILES::BLOCKS::ID::LEAD);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::BISMUTH);
-                    }
-                }
-                break;
-            }
-            case 26 ... 35: {  //++ caves Layer
-                if (currentBlockID == TILES::BLOCKS::ID::ANDESITE || currentBlockID == TILES::BLOCKS::ID::DIORITE || currentBlockID == TILES::BLOCKS::ID::GRANITE) {
-                    if (oreChoice <= 20) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 30), sizeX, sizeY, TILES::BLOCKS::ID::ZINC);
-                    } else if (oreChoice <= 40) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 25), sizeX, sizeY, TILES::BLOCKS::ID::COPPER);
-                    } else if (oreChoice <= 45) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::ALUMINIUM);
-                    } else if (oreChoice <= 60) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::BRONZE);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::IRON);
-                    }
-                }
-                break;
-            }
-            case 36 ... 50: {  //++ deep Caves Layer
-                if (currentBlockID == TILES::BLOCKS::ID::SLATE || currentBlockID == TILES::BLOCKS::ID::MARBLE || currentBlockID == TILES::BLOCKS::ID::SERPENTINITE) {
-                    if (oreChoice <= 30) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 30), sizeX, sizeY, TILES::BLOCKS::ID::SILVER);
-                    } else if (oreChoice <= 55) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 20), sizeX, sizeY, TILES::BLOCKS::ID::TUNGSTEN);
-                    } else if (oreChoice <= 75) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::GOLD);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::PLATINUM);
-                    }
-                }
-                break;
-            }
-            case 51 ... 68: {  //++ Compression Layer
-                if (currentBlockID == TILES::BLOCKS::ID::QUARTZITE || currentBlockID == TILES::BLOCKS::ID::GNEISS) {
-                    if (oreChoice <= 10) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 5), sizeX, sizeY, TILES::BLOCKS::ID::GALENA);
-                    } else if (oreChoice <= 25) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 25), sizeX, sizeY, TILES::BLOCKS::ID::HEMATITE);
-                    } else if (oreChoice <= 60) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 30), sizeX, sizeY, TILES::BLOCKS::ID::COBALT);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::TITANIUM);
-                    }
-                }
-                break;
-            }
-            case 69 ... 73: {  //++ outer Core Layer
-                if (currentBlockID == TILES::BLOCKS::ID::BASALT) {
-                    if (oreChoice <= 10) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 40), sizeX, sizeY, TILES::BLOCKS::ID::ADAMANTITE);
-                    } else if (oreChoice <= 25) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::MITHRILITE);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::ORICHALCUM);
-                    }
-                }
-                break;
-            }
-            case 74 ... 88: {  //++ inner Core Layer
-                if (currentBlockID == TILES::BLOCKS::ID::KIMBERLITE) {
-                    if (oreChoice <= 50) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 25), sizeX, sizeY, TILES::BLOCKS::ID::OSMIUM);
-                    } else if (oreChoice <= 90) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::IRIDIUM);
-                    } else if (oreChoice <= 95) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 7), sizeX, sizeY, TILES::BLOCKS::ID::URANIUM);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 5), sizeX, sizeY, TILES::BLOCKS::ID::PLUTONIUM);
-                    }
-                }
-                break;
-            }
-            case 89 ... 101: { //++ bedrock Layer
-                if (currentBlockID == TILES::BLOCKS::ID::KIMBERLITE) {
-                    if (oreChoice <= 20) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::OSMIUM);
-                    } else if (oreChoice <= 40) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::IRIDIUM);
-                    } else if (oreChoice <= 80) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::URANIUM);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::PLUTONIUM);
-                    }
-                }
-                break;
-            }
-            default: {
-                break;
-            }
-        }
-    } else {
-        int gemChoice = rand() % 100;
-
-        switch (percent) {
-            case 0 ... 5: {   //++ space Layer
-                break;
-            }
-            case 6 ... 16: {   //++ sky Layer
-                break;
-            }
-            case 17 ... 20: { //++ surface Layer
-                break;
-            }
-            case 21 ... 25: {  //++ ground Layer
-                if (currentBlockID == TILES::BLOCKS::ID::CHALK || currentBlockID == TILES::BLOCKS::ID::SHALE || currentBlockID == TILES::BLOCKS::ID::LIMESTONE) {
-                    if (gemChoice <= 70) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 20), sizeX, sizeY, TILES::BLOCKS::ID::QUARTZ);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::AMETHYST);
-                    }
-                }
-                break;
-            }
-            case 26 ... 35: {  //++ caves Layer
-                if (currentBlockID == TILES::BLOCKS::ID::ANDESITE || currentBlockID == TILES::BLOCKS::ID::DIORITE || currentBlockID == TILES::BLOCKS::ID::GRANITE) {
-                    fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 15), sizeX, sizeY, TILES::BLOCKS::ID::ONYX);
-                }
-                break;
-            }
-            case 36 ... 50: {  //++ deep Caves Layer
-                if (currentBlockID == TILES::BLOCKS::ID::SLATE || currentBlockID == TILES::BLOCKS::ID::MARBLE || currentBlockID == TILES::BLOCKS::ID::SERPENTINITE) {
-                    if (gemChoice <= 55) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 20), sizeX, sizeY, TILES::BLOCKS::ID::AQUAMARINE);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::TOPAZ);
-                    }
-                }
-                break;
-            }
-            case 51 ... 68: {  //++ Compression Layer
-                if (currentBlockID == TILES::BLOCKS::ID::QUARTZITE || currentBlockID == TILES::BLOCKS::ID::GNEISS) {
-                    if (gemChoice <= 10) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 5), sizeX, sizeY, TILES::BLOCKS::ID::SAPPHIRE);
-                    } else if (gemChoice <= 60) {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 30), sizeX, sizeY, TILES::BLOCKS::ID::RUBY);
-                    } else {
-                        fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::EMERALD);
-                    }
-                }
-                break;
-            }
-            case 69 ... 73: {  //++ outer Core Layer
-                if (currentBlockID == TILES::BLOCKS::ID::BASALT) {
-                    fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 40), sizeX, sizeY, TILES::BLOCKS::ID::TANZANITE);
-                }
-                break;
-            }
-            case 74 ... 88: {  //++ inner Core Layer
-                if (currentBlockID == TILES::BLOCKS::ID::KIMBERLITE) {
-                    fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 5), sizeX, sizeY, TILES::BLOCKS::ID::DIAMOND);
-                }
-                break;
-            }
-            case 89 ... 101: { //++ bedrock Layer
-                if (currentBlockID == TILES::BLOCKS::ID::KIMBERLITE) {
-                    fillArea(tileMap, noiseMap, x, y, limitMin, limitMax+ (rand() % 10), sizeX, sizeY, TILES::BLOCKS::ID::DIAMOND);
-                }
-                break;
-            }
-            default: {
-                break;
-            }
-        }
-    }
-}
-
-void generateOres(Tile* tileMap, int* noiseMap, int sizeX, int sizeY) {
-    for (int y = 0; y < sizeY; ++y) {
-        for (int x = 0; x < sizeX; ++x) {
-            int index = y * sizeX + x;
-            decideOreAt(x, y, tileMap, noiseMap, sizeX, sizeY, index);
-        }
-    }
-}
-
-void savingWoldFile(const std::string& worldName, Tile* tileMap, int sizeX, int sizeY, int seed, int* perlinNoiseMap) {
-    std::string worldFilePath = path + "/worlds/" + worldName + "/worldData/map/world_" + std::to_string(sizeX) + "x" + std::to_string(sizeY) + "_seed" + std::to_string(seed) + ".wld";
-
-    std::ofstream worldFile(worldFilePath);
-    if (!worldFile.is_open()) {
-        JFLX::log("World Generation: ", "Failed to open world file!", JFLX::LOGTYPE::ERROR);
-    }
-
-    for (int y = 0; y < sizeY; ++y) {
-        for (int x = 0; x < sizeX; ++x) {
-            worldFile << perlinNoiseMap[y * sizeX + x];
-            if (x < sizeX - 1)
-                worldFile << " ";
-        }
-        worldFile << "\n";
-    }
-    worldFile.close();
-}
-
- /*
- * Creates A new world with params
- * Sizes (SizeTemplate, factor 2):
- * -1    test             1.000 x    750
- *  0    Tiny             2.000 x  1.500
- *  1    Small            4.000 x  3.000
- *  2    Medium           6.000 x  4.500
- *  3    Large            8.000 x  6.000
- *  4    Extra Large     10.000 x  7.500
- *  5    Huge            12.000 x  9.000
- *
- * Height Distribution:
- * 5% 	space       Layer
- * 10%	sky         Layer
- * 5%	surface     Layer
- * 5%	ground      Layer
- * 10%	caves       Layer
- * 15%	deep Caves  Layer
- * 18%	compression Layer
- * 5%	outer Core  Layer
- * 15%	inner Core  Layer
- * 2%	bedrock     Layer
- */
-void generateWorld(const std::string worldName, int sizeTemplate, int seed, std::array<int, 4> previews) {
-    //-> Some Insight: https://www.youtube.com/watch?v=Pgt82G4Jxac&t=448s
-
-    JFLX::log("World Generation: ", "Generating world...", JFLX::LOGTYPE::SUCCESS);
-    
-    JFLX::log("World Generation: ", "Setting Up Random Seed..", JFLX::LOGTYPE::SUCCESS);
-    srand(seed);
-
-    //++ Determine World Size and Smoothness
-    int sizeX, sizeY, smoothness;
-    switch (sizeTemplate) {
-        case -1:
-            sizeX       = 1000;
-            sizeY       = 750;
-            smoothness  = 32;
-            break;
-        case 0:
-            sizeX       = 2000;
-            sizeY       = 1500;
-            smoothness  = 64;
-            break;
-        case 1:
-            sizeX       = 4000;
-            sizeY       = 3000;
-            smoothness  = 64;
-            break;
-        case 2:
-            sizeX       = 6000;
-            sizeY       = 4500;
-            smoothness  = 192;
-            break;
-        case 3:
-            sizeX       = 8000;
-            sizeY       = 6000;
-            smoothness  = 256;
-            break;
-        case 4:
-            sizeX       = 10000;
-            sizeY       = 7500;
-            smoothness  = 320;
-            break;
-        case 5:
-            sizeX       = 12000;
-            sizeY       = 9000;
-            smoothness  = 384;
-            break;
-        default:
-            JFLX::log("World Generation: ", "Invalid size template specified. Using default (Medium).", JFLX::LOGTYPE::WARNING);
-            sizeX       = 6000;
-            sizeY       = 4500;
-            smoothness  = 192;
-            break;
-    }
-
-    //++ Create 2D Arrays
-    JFLX::log("World Generation: ", "Creating 2d arrays.", JFLX::LOGTYPE::SUCCESS);
-    Tile* tileMap       = new Tile[sizeX * sizeY];
-    int* perlinNoiseMap = new int[sizeX * sizeY];
-    int* rockMap        = new int[sizeX * sizeY];
-    int* veinMap        = new int[sizeX * sizeY];
-
-    //++ Generate Perlin Noise Map
-    JFLX::log("World Generation: ", "Generating Perlin noise map.", JFLX::LOGTYPE::SUCCESS);
-    JFLX::perlinNoise(perlinNoiseMap, sizeX, sizeY, seed, smoothness);
-    JFLX::perlinNoise(rockMap, sizeX, sizeY, seed, (90+(rand()%10)));
-    JFLX::perlinNoise(veinMap, sizeX, sizeY, seed, (125+(rand()%10)));
-    JFLX::log("World Generation: ", "Completed Generating Perlin noise map.", JFLX::LOGTYPE::SUCCESS);
-
-    
-    if (tileMap == nullptr || perlinNoiseMap == nullptr || rockMap == nullptr || veinMap == nullptr) {
-        JFLX::log("World Generation: ", "One of the pointers is null! Can not continue Generation!", JFLX::LOGTYPE::ERROR);
-        return;
-    }
-
-    //++ Set Tiles by Layer
-    JFLX::log("World Generation: ", "Generate Layers.", JFLX::LOGTYPE::SUCCESS);
-    setTilesByLayer(tileMap, perlinNoiseMap, rockMap, sizeX, sizeY);
-    JFLX::log("World Generation: ", "Finished Generating Layering.", JFLX::LOGTYPE::SUCCESS);
-
-    //++ Generate Ores based on noise value and depth
-    JFLX::log("World Generation: ", "Generating Ores.", JFLX::LOGTYPE::SUCCESS);
-    generateOres(tileMap, veinMap, sizeX, sizeY);
-    JFLX::log("World Generation: ", "Finished Generating Ores.", JFLX::LOGTYPE::SUCCESS);
-
-    //++ Surface Level
-    JFLX::log("World Generation: ", "Generating Surface level.", JFLX::LOGTYPE::SUCCESS);
-    generateSurfaceLevel(tileMap, sizeX, sizeY);
-    JFLX::log("World Generation: ", "Finished Generating Surface level.", JFLX::LOGTYPE::SUCCESS);
-
-    //++ Create Jungle Biome
-    JFLX::log("World Generation: ", "Generating Jungle Biome.", JFLX::LOGTYPE::SUCCESS);
-    std::unordered_map<TILES::BLOCKS::ID, TILES::TileArray> replaceMapBlockJungle = {
-        {TILES::BLOCKS::ID::GRASS,      {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::BLOCKS::ID::DIRT,       {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::BLOCKS::ID::SHALE,      {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::BLOCKS::ID::ANDESITE,   {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::BLOCKS::ID::SLATE,      {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::BLOCKS::ID::GNEISS,     {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
-    };
-
-    std::unordered_map<TILES::WALLS::ID, TILES::TileArray> replaceMapWallJungle = {
-        {TILES::WALLS::ID::GRASS,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::WALLS::ID::DIRT,        {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::WALLS::ID::SHALE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::WALLS::ID::ANDESITE,    {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::WALLS::ID::SLATE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
-        {TILES::WALLS::ID::GNEISS,      {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
-    };
-
-    int jungleRadius = static_cast<int>((sizeX/8)+(rand()%50));
-    int jungleHalfRadius = static_cast<int>(0.5*jungleRadius);
-    int jungleSecondRadius = static_cast<int>(0.85*jungleRadius);
-    int jungleX = rand() % sizeX;
-    int jungleY = static_cast<int>((sizeY/3));
-
-    fillCircularArea(tileMap, jungleX, jungleY, jungleRadius, sizeX, sizeY, &replaceMapBlockJungle, &replaceMapWallJungle);
-    fillCircularArea(tileMap, jungleX, jungleY+jungleHalfRadius, jungleSecondRadius, sizeX, sizeY, &replaceMapBlockJungle, &replaceMapWallJungle);
-    JFLX::log("World Generation: ", "Finished Generating Jungle Biome.", JFLX::LOGTYPE::SUCCESS);
-
-    //++ Create Ice Biome
-    JFLX::log("World Generation: ", "Generating Ice Biome.", JFLX::LOGTYPE::SUCCESS);
-    std::unordered_map<TILES::BLOCKS::ID, TILES::TileArray> replaceMapBlockIce = {
-        {TILES::BLOCKS::ID::GRASS,      {TILES::BLOCKS::ID::SNOWGRASS, TILES::WALLS::ID::SNOWGRASS}},
-        {TILES::BLOCKS::ID::DIRT,       {TILES::BLOCKS::ID::SNOWDIRT, TILES::WALLS::ID::SNOWDIRT}},
-        {TILES::BLOCKS::ID::SHALE,      {TILES::BLOCKS::ID::SNOWDIRT, TILES::WALLS::ID::SNOWDIRT}},
-        {TILES::BLOCKS::ID::ANDESITE,   {TILES::BLOCKS::ID::ICEBLOCK, TILES::WALLS::ID::ICEBLOCK}},
-        {TILES::BLOCKS::ID::SLATE,      {TILES::BLOCKS::ID::ICEBLOCK, TILES::WALLS::ID::ICEBLOCK}},
-        {TILES::BLOCKS::ID::GNEISS,     {TILES::BLOCKS::ID::ICEBLOCK, TILES::WALLS::ID::ICEBLOCK}},
-    };
-
-    std::unordered_map<TILES::WALLS::ID, TILES::TileArray> replaceMapWallIce = {
-        {TILES::WALLS::ID::GRASS,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::SNOWGRASS}},
-        {TILES::WALLS::ID::DIRT,        {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::SNOWDIRT}},
-        {TILES::WALLS::ID::SHALE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::SNOWDIRT}},
-        {TILES::WALLS::ID::ANDESITE,    {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::ICEBLOCK}},
-        {TILES::WALLS::ID::SLATE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::ICEBLOCK}},
-        {TILES::WALLS::ID::GNEISS,      {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::ICEBLOCK}},
-    };
-
-    int iceRadius = static_cast<int>((sizeX/8)+(rand()%50));
-    int iceHalfRadius = static_cast<int>(0.5*iceRadius);
-    int iceSecondRadius = static_cast<int>(0.95*iceRadius);
-    int iceX = (jungleX + (sizeX/2)) > sizeX ? (jungleX - (sizeX/2)) : sizeX - (jungleX - (sizeX/2));
-    int iceY = static_cast<int>((sizeY/3));
-
-    fillCircularArea(tileMap, iceX, iceY, iceRadius, sizeX, sizeY, &replaceMapBlockIce, &replaceMapWallIce);
-    fillCircularArea(tileMap, iceX, iceY+iceHalfRadius, iceSecondRadius, sizeX, sizeY, &replaceMapBlockIce, &replaceMapWallIce);
-    JFLX::log("World Generation: ", "Finished Generating Ice Biome.", JFLX::LOGTYPE::SUCCESS);
-
-    //! Add a Tree Processing function
-    //++
-
-    //++ Bedrock Level
-    JFLX::log("World Generation: ", "Generating Bedrock level.", JFLX::LOGTYPE::SUCCESS);
-    generateBedrockLevel(tileMap, sizeX, sizeY);
-    JFLX::log("World Generation: ", "Finished Generating Bedrock level.", JFLX::LOGTYPE::SUCCESS);
-
-    //++ Save World Data
-    JFLX::log("World Generation: ", "Saving world data (.wld).", JFLX::LOGTYPE::SUCCESS);
-
-    //++ Create World Directory
-    if (!fs::exists(path + "/worlds/" + worldName)) {
-        JFLX::log("World Generation: ", "Creating World Directory.", JFLX::LOGTYPE::INFO);
-        fs::create_directories(path + "/worlds/" + worldName + "/worldData/map/");
-    } else {
-        JFLX::log("World Generation: ", "World Directory already exists. Replacing Old World Data.", JFLX::LOGTYPE::WARNING);
-    }
-
-    //++ Save World File
-    savingWoldFile(worldName, tileMap, sizeX, sizeY, seed, perlinNoiseMap);
-
-    JFLX::log("World Generation: ", "Saved world data (.wld).", JFLX::LOGTYPE::SUCCESS);
-
-    //++ Save Preview Images
-    JFLX::log("World Generation: ", "Saving Preview Image(s) (.png).", JFLX::LOGTYPE::SUCCESS);
-    if (previews[0] == 1) {generateAndSaveNoisePreviewImage(perlinNoiseMap, "perlinNoise", sizeX, sizeY, worldName);}
-    if (previews[1] == 1) {generateAndSaveNoisePreviewImage(rockMap, "rockMap", sizeX, sizeY, worldName);}
-    if (previews[2] == 1) {generateAndSaveNoisePreviewImage(veinMap, "veinMap", sizeX, sizeY, worldName);}
-    if (previews[3] == 1) {generateAndSaveTilePreviewImage(tileMap, sizeX, sizeY, worldName);}
-
-    //++ Clean Up
-    delete[] tileMap;
-    delete[] perlinNoiseMap;
-    delete[] veinMap;
-    JFLX::log("World Generation: ", "World generation completed.", JFLX::LOGTYPE::SUCCESS);
-}
-
-/*
-++ Arguments:
- argv[1] = worldName (string)
- argv[2] = sizeTemplate (int)
- argv[3] = seed (int)
- argv[4] = preview Perlin Noise Map (bool) 0 / false, 1 / true
- argv[5] = preview rock Noise Map (bool) 0 / false, 1 / true
- argv[6] = preview vein Noise Map (bool) 0 / false, 1 / true
- argv[7] = preview Tile Map (bool) 0 / false, 1 / true
-*/
-int main(int argc, char* argv[]) {
-    if (argc < 8) {
-        JFLX::log("World Generation: ", "Insufficient arguments provided. Usage: <worldName> [sizeTemplate] [seed] [preview Perlin Noise Map] [preview rock Noise Map] [preview vein Noise Map] [preview Tile Map]", JFLX::LOGTYPE::ERROR);
-        return 1;
-    }
-    
-    std::string combined;
-    for (int i = 0; i < argc; ++i) {
-        combined += argv[i];
-        if (i < argc - 1) combined += ", ";
-    }
-
-    JFLX::log("World Generation: ", "Running: " + combined, JFLX::LOGTYPE::SUCCESS);
-
-    generateWorld(argv[1], (argv[2] ? std::stoi(argv[2]) : -1), (argv[3] ? std::stoi(argv[3]) : 12345), {std::stoi(argv[4]), std::stoi(argv[5]), std::stoi(argv[6]), std::stoi(argv[7])});
-
-    return 0;
-}
+//_ CRUSADIA - World Generation CPP FILE _//_ COPYRIGHT (C) 2024 JFLX STUDIO - ALL RIGHTS RESERVED _//
+
+#include <iostream>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <string>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <cstring>
+#include <charconv>
+#include <utility>
+#include <functional>
+
+#include <JFLX/logging.hpp>
+#include <JFLX/perlinNoise.hpp>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <STB/stb_image_write.h>
+
+#include "tiles.hpp"
+#include "generationPlanes.hpp"
+#include "generationNoise.hpp"
+#include "generationRules.hpp"
+#include "generationBiomes.hpp"
+#include "generationRandom.hpp"
+#include "generationPreview.hpp"
+#include "generationStructures.hpp"
+#include "generationTiming.hpp"
+#include "generationArena.hpp"
+#include "generationCache.hpp"
+#include "colorStruct.hpp"
+
+namespace fs = std::filesystem;
+
+std::string path = fs::current_path().string() + "/";
+
+std::vector<std::array<int, 2>> treeSeedsToProcess = {};
+
+//++ Matches CHUNKSIZE in room.hpp, streamed bands are always whole rows of chunks
+static constexpr int GENERATION_CHUNKSIZE = 16;
+
+std::string previewPath(const std::string& worldName, const std::string& imageName) {
+    return path + "/worlds/" + worldName + "/worldData/" + imageName + "Preview";
+}
+
+//++ Renders the preview now, the PNG is written in the background by previewEncoder()
+void generateAndSaveNoisePreviewImage(const uint8_t* noisePlane, std::string imageName, int sizeX, int sizeY, const std::string& worldName, const PreviewSettings& settings) {
+    int width  = previewSize(sizeX, settings.downscale);
+    int height = previewSize(sizeY, settings.downscale);
+
+    std::vector<uint8_t> img = previewEncoder().acquireBuffer(size_t(width) * height * 3);
+    renderNoisePreview(noisePlane, sizeX, sizeY, settings.downscale, img.data());
+    previewEncoder().submit(previewPath(worldName, imageName), std::move(img), width, height, settings.tileSize);
+}
+
+void generateAndSaveTilePreviewImage(const TilePlanes& tileMap, int sizeX, int sizeY, const std::string& worldName, const PreviewSettings& settings) {
+    int width  = previewSize(sizeX, settings.downscale);
+    int height = previewSize(sizeY, settings.downscale);
+
+    std::vector<uint8_t> img = previewEncoder().acquireBuffer(size_t(width) * height * 3);
+    renderTilePreview(tileMap, settings.downscale, 0, sizeY, img.data());
+    previewEncoder().submit(previewPath(worldName, "tile"), std::move(img), width, height, settings.tileSize);
+}
+
+//++ Fills one tile of a flood fill, false when the fill does not spread from it (outside the limits / held rows or already filled)
+bool fillAreaTile(TilePlanes& tileMap, const uint8_t* noiseMap, int targetX, int targetY, int limitMin, int limitMax, TILES::BLOCKS::ID blockID, TILES::WALLS::ID wallID, bool replaceAir, bool airWithWalls) {
+    //++ Tiles outside of the held rows (streamed window) are never touched
+    if (!tileMap.holds(targetX, targetY)) {
+        return false;
+    }
+
+    size_t index = tileMap.indexOf(targetX, targetY);
+    TILES::BLOCKS::ID targetBlockID = tileMap.block(index);
+    TILES::WALLS::ID targetWallID = tileMap.wall(index);
+    int noiseValue = noiseMap[index];
+
+
+    if ((noiseValue < limitMin) || (noiseValue > limitMax)) {
+        return false;
+    }
+
+    if (!replaceAir && targetBlockID == TILES::BLOCKS::ID::AIR || replaceAir && airWithWalls && targetWallID == wallID || targetBlockID == blockID) {
+        return false;
+    }
+
+    if (replaceAir) {
+        if (airWithWalls) {
+            if (targetBlockID == TILES::BLOCKS::ID::AIR) {
+                tileMap.set(index, TILES::BLOCKS::ID::NOCHANGE, wallID);
+            } else {
+                tileMap.set(index, blockID);
+            }
+        } else {
+            tileMap.set(index, blockID);
+        }
+    } else {
+        tileMap.set(index, blockID);
+    }
+    return true;
+}
+
+/*
+++ Flood Fill Algorithm to fill areas based on noise values
+Uses a work list in the generation arena instead of recursion, so big areas can not overflow the stack.
+A tile only depends on its own state, so the filled area is the same in every visiting order.
+
+Directions array:
+[0] = Up
+[1] = Left
+[2] = Right
+[3] = Down
+
+!! Filling Caves with water should only go down, left and right, not up.!!
+*/
+void fillArea(TilePlanes& tileMap, const uint8_t* noiseMap, int targetX, int targetY, int limitMin, int limitMax, TILES::BLOCKS::ID blockID, TILES::WALLS::ID wallID = TILES::WALLS::ID::NOCHANGE, bool replaceAir = false, bool airWithWalls = true, std::array<bool,4> directions = {true, true, true, true}) {
+    GenerationArena& arena = generationArena();
+    ArenaMarker scratch = arena.mark();
+    {
+        ArenaVector<std::array<int, 2>> workList(&arena);
+        workList.reserve(256);
+        workList.push_back({targetX, targetY});
+
+        while (!workList.empty()) {
+            auto [x, y] = workList.back();
+            workList.pop_back();
+
+            if (!fillAreaTile(tileMap, noiseMap, x, y, limitMin, limitMax, blockID, wallID, replaceAir, airWithWalls)) {
+                continue;
+            }
+
+            //++ Pushed in reverse, so right / left / down / up are visited in the order of the former recursion
+            if (directions[0]) {workList.push_back({x, y - 1});} // Up
+            if (directions[3]) {workList.push_back({x, y + 1});} // Down
+            if (directions[1]) {workList.push_back({x - 1, y});} // Left
+            if (directions[2]) {workList.push_back({x + 1, y});} // Right
+        }
+    }
+    arena.rewind(scratch);
+}
+
+//++ Biome Replace Maps
+const std::unordered_map<TILES::BLOCKS::ID, TILES::TileArray> replaceMapBlockJungle = {
+    {TILES::BLOCKS::ID::GRASS,      {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::BLOCKS::ID::DIRT,       {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::BLOCKS::ID::SHALE,      {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::BLOCKS::ID::ANDESITE,   {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::BLOCKS::ID::SLATE,      {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::BLOCKS::ID::GNEISS,     {TILES::BLOCKS::ID::JUNGLEGRASS, TILES::WALLS::ID::JUNGLEGRASS}},
+};
+
+const std::unordered_map<TILES::WALLS::ID, TILES::TileArray> replaceMapWallJungle = {
+    {TILES::WALLS::ID::GRASS,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::WALLS::ID::DIRT,        {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::WALLS::ID::SHALE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::WALLS::ID::ANDESITE,    {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::WALLS::ID::SLATE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
+    {TILES::WALLS::ID::GNEISS,      {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::JUNGLEGRASS}},
+};
+
+const std::unordered_map<TILES::BLOCKS::ID, TILES::TileArray> replaceMapBlockIce = {
+    {TILES::BLOCKS::ID::GRASS,      {TILES::BLOCKS::ID::SNOWGRASS, TILES::WALLS::ID::SNOWGRASS}},
+    {TILES::BLOCKS::ID::DIRT,       {TILES::BLOCKS::ID::SNOWDIRT, TILES::WALLS::ID::SNOWDIRT}},
+    {TILES::BLOCKS::ID::SHALE,      {TILES::BLOCKS::ID::SNOWDIRT, TILES::WALLS::ID::SNOWDIRT}},
+    {TILES::BLOCKS::ID::ANDESITE,   {TILES::BLOCKS::ID::ICEBLOCK, TILES::WALLS::ID::ICEBLOCK}},
+    {TILES::BLOCKS::ID::SLATE,      {TILES::BLOCKS::ID::ICEBLOCK, TILES::WALLS::ID::ICEBLOCK}},
+    {TILES::BLOCKS::ID::GNEISS,     {TILES::BLOCKS::ID::ICEBLOCK, TILES::WALLS::ID::ICEBLOCK}},
+};
+
+const std::unordered_map<TILES::WALLS::ID, TILES::TileArray> replaceMapWallIce = {
+    {TILES::WALLS::ID::GRASS,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::SNOWGRASS}},
+    {TILES::WALLS::ID::DIRT,        {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::SNOWDIRT}},
+    {TILES::WALLS::ID::SHALE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::SNOWDIRT}},
+    {TILES::WALLS::ID::ANDESITE,    {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::ICEBLOCK}},
+    {TILES::WALLS::ID::SLATE,       {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::ICEBLOCK}},
+    {TILES::WALLS::ID::GNEISS,      {TILES::BLOCKS::ID::NOCHANGE, TILES::WALLS::ID::ICEBLOCK}},
+};
+
+/*
+++ Places the jungle and the ice biome (two circles each)
+*/
+std::vector<Biome> createBiomes(const GenerationRandom& random, int sizeX, int sizeY) {
+    std::vector<Biome> biomes;
+
+    Biome& jungle = biomes.emplace_back(replaceMapBlockJungle, replaceMapWallJungle);
+    int jungleRadius = static_cast<int>((sizeX/8)+random.range(RANDOMSTAGE::BIOMES, 0, 0, 50));
+    int jungleHalfRadius = static_cast<int>(0.5*jungleRadius);
+    int jungleSecondRadius = static_cast<int>(0.85*jungleRadius);
+    int jungleX = static_cast<int>(random.range(RANDOMSTAGE::BIOMES, 0, 1, sizeX));
+    int jungleY = static_cast<int>((sizeY/3));
+    jungle.addCircle(jungleX, jungleY, jungleRadius);
+    jungle.addCircle(jungleX, jungleY+jungleHalfRadius, jungleSecondRadius);
+
+    Biome& ice = biomes.emplace_back(replaceMapBlockIce, replaceMapWallIce);
+    int iceRadius = static_cast<int>((sizeX/8)+random.range(RANDOMSTAGE::BIOMES, 1, 0, 50));
+    int iceHalfRadius = static_cast<int>(0.5*iceRadius);
+    int iceSecondRadius = static_cast<int>(0.95*iceRadius);
+    int iceX = (jungleX + (sizeX/2)) > sizeX ? (jungleX - (sizeX/2)) : sizeX - (jungleX - (sizeX/2));
+    int iceY = static_cast<int>((sizeY/3));
+    ice.addCircle(iceX, iceY, iceRadius);
+    ice.addCircle(iceX, iceY+iceHalfRadius, iceSecondRadius);
+
+    return biomes;
+}
+
+/*
+++ Layering from the compiled layer tables (see generationRules.hpp)
+noise A decides block or air, noise B decides the rock of the layer, the layer itself is looked up once per row
+*/
+void setTilesByLayer(TilePlanes& tileMap, const uint8_t* noiseMapA, const uint8_t* noiseMapB, int sizeX, int rowBegin, int rowEnd, const ArenaVector<uint8_t>& rowLayers) {
+    const uint8_t air = static_cast<uint8_t>(TILES::BLOCKS::ID::AIR);
+
+    generationWorkers().parallelFor(rowBegin, rowEnd, 16, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            const CompiledLayer& layer = generationRules.layers[rowLayers[y]];
+            size_t rowIndex = tileMap.indexOf(0, y);
+
+            const uint8_t* a = noiseMapA + rowIndex;
+            const uint8_t* b = noiseMapB + rowIndex;
+            uint8_t* blocks  = tileMap.blocks.get() + rowIndex;
+            uint8_t* walls   = tileMap.walls.get() + rowIndex;
+
+            for (int x = 0; x < sizeX; ++x) {
+                uint8_t solid = layer.solidMask[a[x]];
+                blocks[x] = (layer.rockBlock[b[x]] & solid) | (air & ~solid);
+                walls[x]  = layer.rockWall[b[x]];
+            }
+        }
+    });
+}
+
+/*
+++ Complex Wave Function for surfacelevel variation
+*/
+double complexWave(double x) {
+    // first part
+    double part1 = (1.0 + 0.33 * sin(2.0 * x)) * sin(x + 0.5 * sin(M_PI * x)) + 0.6 * sin(M_E * x) + 0.25 * sin(pow(x, 1.33));
+
+    // envelope/multiplier
+    double envelope = -2.0 + 0.2 * sin(M_PI * x) + 0.3 * sin(0.05 * x * x);
+
+    // final result
+    return part1 - envelope * part1 - M_PI;
+}
+
+//++ Surface data of one column, shared by generateWorld and the streamed generation
+struct SurfaceColumn {
+    int height      = 0;
+    int grassDepth  = 1;
+    bool treeRoll   = false;
+    int bedrock     = 0;
+};
+
+ArenaVector<SurfaceColumn> computeSurfaceColumns(const GenerationRandom& random, int sizeX, int sizeY) {
+    ArenaVector<SurfaceColumn> columns(sizeX, &generationArena());
+    for (int x = 0; x < sizeX; ++x) {
+        columns[x].height     = 10+static_cast<int>(sizeY*0.16 - 2.5*complexWave(x * 0.05));
+        columns[x].grassDepth = 1 + random.range(RANDOMSTAGE::SURFACE, x, 0, 4);
+        columns[x].treeRoll   = random.range(RANDOMSTAGE::TREES, x, 0, 5) == 1;
+        columns[x].bedrock    = static_cast<int>(sizeY*0.98 + complexWave(x));
+    }
+    return columns;
+}
+
+void addTreeSeed(TilePlanes& tileMap, int x, int y, bool treeRoll) {
+    if (!tileMap.holds(x, y+1)) {
+        return;
+    }
+    if (tileMap.block(tileMap.indexOf(x, y+1)) != TILES::BLOCKS::ID::AIR) {
+        if (treeRoll) {
+            tileMap.set(tileMap.indexOf(x, y), TILES::BLOCKS::ID::TREESEED);
+            treeSeedsToProcess.push_back({x, y});
+        }
+    }
+}
+
+/*
+++ Carves the sky above the surface and places grass below it on the world rows [rowBegin, rowEnd)
+Rows are processed in parallel, tree seeds afterwards in column order (grass never changes whether a tile is air)
+*/
+void generateSurfaceLevel(TilePlanes& tileMap, const ArenaVector<SurfaceColumn>& columns, int sizeX, int rowBegin, int rowEnd) {
+    generationWorkers().parallelFor(rowBegin, rowEnd, 16, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            size_t rowIndex = tileMap.indexOf(0, y);
+            for (int x = 0; x < sizeX; ++x) {
+                const SurfaceColumn& column = columns[x];
+                size_t index = rowIndex + x;
+
+                if (y > 0 && y <= column.height) {
+                    tileMap.set(index, TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::AIR);
+                } else if (y > column.height && y <= column.height + column.grassDepth) {
+                    if (tileMap.block(index) != TILES::BLOCKS::ID::AIR) {
+                        tileMap.set(index, TILES::BLOCKS::ID::GRASS, TILES::WALLS::ID::GRASS);
+                    } else {
+                        tileMap.set(index, TILES::BLOCKS::ID::AIR, TILES::WALLS::ID::GRASS);
+                    }
+                }
+            }
+        }
+    });
+
+    for (int x = 0; x < sizeX; ++x) {
+        if (columns[x].height >= rowBegin && columns[x].height < rowEnd) {
+            addTreeSeed(tileMap, x, columns[x].height, columns[x].treeRoll);
+        }
+    }
+}
+
+//++ Grows the "tree" structure on every collected tree seed held by tileMap, the seeds are consumed
+void generateTrees(TilePlanes& tileMap, const GenerationRandom& random) {
+    const CompiledStructure* tree = findStructure(generationRules, "tree");
+    if (tree != nullptr && !treeSeedsToProcess.empty()) {
+        int placed = placeStructures(tileMap, *tree, treeSeedsToProcess, random);
+        JFLX::log("World Generation: ", "Placed " + std::to_string(placed) + " of " + std::to_string(treeSeedsToProcess.size()) + " trees.", JFLX::LOGTYPE::INFO);
+    }
+    treeSeedsToProcess.clear();
+}
+
+void generateBedrockLevel(TilePlanes& tileMap, const ArenaVector<SurfaceColumn>& columns, int sizeX, int rowBegin, int rowEnd) {
+    int highestBedrock = rowEnd;
+    for (const SurfaceColumn& column : columns) {
+        highestBedrock = std::min(highestBedrock, column.bedrock + 1);
+    }
+
+    generationWorkers().parallelFor(std::max(rowBegin, highestBedrock), rowEnd, 16, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            size_t rowIndex = tileMap.indexOf(0, y);
+            for (int x = 0; x < sizeX; ++x) {
+                if (y > columns[x].bedrock) {
+                    tileMap.set(rowIndex + x, TILES::BLOCKS::ID::BEDROCK, TILES::WALLS::ID::BEDROCK);
+                }
+            }
+        }
+    });
+}
+
+void decideOreAt(int x, int y, TilePlanes& tileMap, const uint8_t* noiseMap, size_t index, const CompiledOreBand& band, const GenerationRandom& random, uint8_t oreRoll) {
+    int noiseValue = noiseMap[index];
+    TILES::BLOCKS::ID currentBlockID = tileMap.block(index);
+
+    int limitMin = generationRules.veinMin;
+    int limitMax = generationRules.veinMax;
+
+    if (noiseValue > limitMax || noiseValue < limitMin || currentBlockID == TILES::BLOCKS::ID::AIR) {
+        return;
+    }
+
+    //++ Decide if ore or gems are choosen
+    bool isOre = oreRoll >= generationRules.gemBelowRoll;
+    int choice = random.range(RANDOMSTAGE::ORES, x, y, 100, 1);
+
+    const std::vector<CompiledVein>& veins = isOre ? band.ores : band.gems;
+    if (veins.empty() || !band.host[static_cast<uint8_t>(currentBlockID)]) {
+        return;
+    }
+
+    const CompiledVein& vein = veins[isOre ? band.oreChoice[choice] : band.gemChoice[choice]];
+    fillArea(tileMap, noiseMap, x, y, limitMin, limitMax + random.range(RANDOMSTAGE::ORES, x, y, vein.spread, 2), vein.block, vein.wall, vein.replaceAir);
+}
+
+/*
+++ Ore veins are flood filled and may overlap, so the veins are placed in row order on one thread.
+The random values only depend on the position, the ore / gem rolls of a row are drawn in one batch.
+*/
+void generateOres(TilePlanes& tileMap, const uint8_t* noiseMap, int sizeX, int rowBegin, int rowEnd, const ArenaVector<uint8_t>& rowOreBands, const GenerationRandom& random) {
+    GenerationArena& arena = generationArena();
+    ArenaMarker scratch = arena.mark();
+    ArenaVector<uint8_t> oreRolls(sizeX, &arena);
+
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const CompiledOreBand& band = generationRules.oreBands[rowOreBands[y]];
+        random.fillRow(RANDOMSTAGE::ORES, 0, y, generationRules.oreRollRange, 0, oreRolls.data(), sizeX);
+
+        for (int x = 0; x < sizeX; ++x) {
+            decideOreAt(x, y, tileMap, noiseMap, tileMap.indexOf(x, y), band, random, oreRolls[x]);
+        }
+    }
+    arena.rewind(scratch);
+}
+
+std::string worldFilePath(const std::string& worldName, int sizeX, int sizeY, int seed) {
+    return path + "/worlds/" + worldName + "/worldData/map/world_" + std::to_string(sizeX) + "x" + std::to_string(sizeY) + "_seed" + std::to_string(seed) + ".wld";
+}
+
+//++ Writes rows of the perlin plane as text rows, used by the full and the streamed generation
+void writeWorldRows(std::ofstream& worldFile, const uint8_t* perlinNoiseRows, int sizeX, int rows) {
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < sizeX; ++x) {
+            worldFile << int(perlinNoiseRows[size_t(y) * sizeX + x]);
+            if (x < sizeX - 1)
+                worldFile << " ";
+        }
+        worldFile << "\n";
+    }
+}
+
+void savingWoldFile(const std::string& worldName, const TilePlanes& tileMap, int sizeX, int sizeY, int seed, const uint8_t* perlinNoiseMap) {
+    std::ofstream worldFile(worldFilePath(worldName, sizeX, sizeY, seed));
+    if (!worldFile.is_open()) {
+        JFLX::log("World Generation: ", "Failed to open world file!", JFLX::LOGTYPE::ERROR);
+    }
+
+    writeWorldRows(worldFile, perlinNoiseMap, sizeX, sizeY);
+    worldFile.close();
+}
+
+/*
+++ Generation Stages
+Every stage after the noise works on the tile planes. Stages that only read and write the rows they are given (rowLocal)
+can be generated or loaded from the stage cache region by region, the others always run on the whole world.
+"parameters" hashes everything the stage reads for the given rows besides the output of the stage before it.
+*/
+struct GenerationStage {
+    std::string name;
+    bool rowLocal = true;
+    std::function<void(int, int)> run;
+    std::function<uint64_t(int, int)> parameters;
+    std::function<void()> finished;     // optional, runs once the stage is generated or skipped (releases what only this stage reads)
+};
+
+//++ Moves the seeds of the region rows out of "seeds" and appends "regionSeeds"
+void replaceRegionSeeds(std::vector<std::array<int, 2>>& seeds, const std::vector<std::array<int, 2>>& regionSeeds, int rowBegin, int rowEnd) {
+    seeds.erase(std::remove_if(seeds.begin(), seeds.end(), [&](const std::array<int, 2>& seed) { return seed[1] >= rowBegin && seed[1] < rowEnd; }), seeds.end());
+    seeds.insert(seeds.end(), regionSeeds.begin(), regionSeeds.end());
+}
+
+/*
+++ Runs the stages in order, with a cache only what changed since the last run is generated:
+1. the key of every stage region chains the key of the stage before it (row local: same region, otherwise all regions) and its parameters
+2. the newest stage that is cached for every region is loaded, the stages before it are skipped
+3. the remaining row local stages load every region that still matches and generate the others, world stages generate everything
+Tree seeds travel with the tile planes, every cache file holds the seeds of its rows that are not grown yet.
+*/
+void runGenerationStages(const std::vector<GenerationStage>& stages, TilePlanes& tileMap, StageCache* cache, uint64_t noiseKey) {
+    int sizeY = tileMap.sizeY;
+
+    if (cache == nullptr) {
+        for (const GenerationStage& stage : stages) {
+            JFLX::log("World Generation: ", "Generating " + stage.name + ".", JFLX::LOGTYPE::SUCCESS);
+            stage.run(0, sizeY);
+            if (stage.finished) stage.finished();
+            generationTimings.lap(stage.name);
+        }
+        return;
+    }
+
+    //++ Stage keys per region
+    int regions = cache->regionCount();
+    std::vector<std::vector<uint64_t>> keys(stages.size(), std::vector<uint64_t>(regions));
+    std::vector<uint64_t> previous(regions, noiseKey);
+    for (size_t s = 0; s < stages.size(); ++s) {
+        if (stages[s].rowLocal) {
+            for (int r = 0; r < regions; ++r) {
+                keys[s][r] = CacheHash().add(previous[r]).add(stages[s].parameters(cache->regionBegin(r), cache->regionEnd(r))).value;
+            }
+        } else {
+            CacheHash hash;
+            for (uint64_t key : previous) hash.add(key);
+            hash.add(stages[s].parameters(0, sizeY));
+            std::fill(keys[s].begin(), keys[s].end(), hash.value);
+        }
+        previous = keys[s];
+    }
+
+    //++ Newest stage that is cached for every region
+    int newest = -1;
+    for (int s = int(stages.size()) - 1; s >= 0 && newest < 0; --s) {
+        bool complete = true;
+        for (int r = 0; r < regions && complete; ++r) {
+            complete = cache->has(stages[s].name, r, keys[s][r]);
+        }
+        if (complete) newest = s;
+    }
+
+    treeSeedsToProcess.clear();
+    if (newest >= 0) {
+        for (int r = 0; r < regions; ++r) {
+            if (!cache->load(stages[newest].name, r, keys[newest][r], {tileMap.blocks.get(), tileMap.walls.get()}, &treeSeedsToProcess)) {
+                JFLX::log("World Generation: ", "Stage cache could not be read, generating every stage.", JFLX::LOGTYPE::WARNING);
+                treeSeedsToProcess.clear();
+                newest = -1;
+                break;
+            }
+        }
+    }
+    for (int s = 0; s <= newest; ++s) {
+        JFLX::log("World Generation: ", "Skipping " + stages[s].name + " (cached).", JFLX::LOGTYPE::INFO);
+        if (stages[s].finished) stages[s].finished();
+    }
+    generationTimings.lap("cache");
+
+    for (size_t s = size_t(newest + 1); s < stages.size(); ++s) {
+        const GenerationStage& stage = stages[s];
+        JFLX::log("World Generation: ", "Generating " + stage.name + ".", JFLX::LOGTYPE::SUCCESS);
+
+        int loaded = 0;
+        if (stage.rowLocal) {
+            for (int r = 0; r < regions; ++r) {
+                int rowBegin = cache->regionBegin(r);
+                int rowEnd   = cache->regionEnd(r);
+
+                std::vector<std::array<int, 2>> regionSeeds;
+                if (cache->load(stage.name, r, keys[s][r], {tileMap.blocks.get(), tileMap.walls.get()}, &regionSeeds)) {
+                    replaceRegionSeeds(treeSeedsToProcess, regionSeeds, rowBegin, rowEnd);
+                    ++loaded;
+                    continue;
+                }
+                stage.run(rowBegin, rowEnd);
+                cache->store(stage.name, r, keys[s][r], {tileMap.blocks.get(), tileMap.walls.get()}, &treeSeedsToProcess);
+            }
+        } else {
+            stage.run(0, sizeY);
+            for (int r = 0; r < regions; ++r) {
+                cache->store(stage.name, r, keys[s][r], {tileMap.blocks.get(), tileMap.walls.get()}, &treeSeedsToProcess);
+            }
+        }
+
+        if (loaded > 0) {
+            JFLX::log("World Generation: ", "Loaded " + std::to_string(loaded) + " of " + std::to_string(regions) + " " + stage.name + " regions from the cache.", JFLX::LOGTYPE::INFO);
+        }
+        if (stage.finished) stage.finished();
+        generationTimings.lap(stage.name);
+    }
+}
+
+//++ Parameter Hashes of the Stages (see GenerationStage)
+uint64_t hashLayerRows(const ArenaVector<uint8_t>& rowLayers, int rowBegin, int rowEnd) {
+    CacheHash hash;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const CompiledLayer& layer = generationRules.layers[rowLayers[y]];
+        hash.add(layer.solidMask).add(layer.rockBlock).add(layer.rockWall);
+    }
+    return hash.value;
+}
+
+uint64_t hashOreRules(const ArenaVector<uint8_t>& rowOreBands) {
+    CacheHash hash;
+    hash.add(generationRules.veinMin).add(generationRules.veinMax).add(generationRules.oreRollRange).add(generationRules.gemBelowRoll);
+    for (const CompiledOreBand& band : generationRules.oreBands) {
+        hash.add(band.host).add(band.oreChoice).add(band.gemChoice);
+        for (const std::vector<CompiledVein>* veins : {&band.ores, &band.gems}) {
+            hash.add(veins->size());
+            for (const CompiledVein& vein : *veins) {
+                hash.add(vein.block).add(vein.wall).add(vein.spread).add(vein.replaceAir);
+            }
+        }
+    }
+    hash.bytes(rowOreBands.data(), rowOreBands.size());
+    return hash.value;
+}
+
+uint64_t hashSurfaceColumns(const ArenaVector<SurfaceColumn>& columns, bool bedrock) {
+    CacheHash hash;
+    for (const SurfaceColumn& column : columns) {
+        if (bedrock) {
+            hash.add(column.bedrock);
+        } else {
+            hash.add(column.height).add(column.grassDepth).add(column.treeRoll);
+        }
+    }
+    return hash.value;
+}
+
+//++ Only the biomes with a circle in the rows count, moving a circle only invalidates the regions it touches
+uint64_t hashBiomeRows(const std::vector<Biome>& biomes, int rowBegin, int rowEnd) {
+    CacheHash hash;
+    for (const Biome& biome : biomes) {
+        bool touched = false;
+        for (const BiomeCircle& circle : biome.circles) {
+            if (circle.centerY + circle.radius >= rowBegin && circle.centerY - circle.radius < rowEnd) {
+                hash.add(circle.centerX).add(circle.centerY).add(circle.radius);
+                touched = true;
+            }
+        }
+        if (touched) {
+            hash.add(biome.blockMatched).add(biome.blockToBlock).add(biome.blockToWall);
+            hash.add(biome.wallMatched).add(biome.wallToBlock).add(biome.wallToWall);
+        }
+    }
+    return hash.value;
+}
+
+uint64_t hashStructure(const CompiledStructure* structure) {
+    CacheHash hash;
+    if (structure == nullptr) return hash.value;
+
+    hash.add(structure->replaceable).add(structure->spacing);
+    for (const StructureVariant& variant : structure->variants) {
+        hash.add(variant.width).add(variant.height).add(variant.anchorX).add(variant.anchorY);
+        hash.bytes(variant.blocks.data(), variant.blocks.size());
+        hash.bytes(variant.walls.data(), variant.walls.size());
+    }
+    return hash.value;
+}
+
+//++ Hands the arena numbers to the stage report and drops the whole world in one step
+void finishWorldArena() {
+    GenerationArena& arena = generationArena();
+    generationTimings.peakMemory = arena.peak();
+    generationTimings.largePages = arena.usesLargePages();
+    arena.reset();
+}
+
+ /*
+ * Creates A new world with params
+ * Sizes (SizeTemplate, factor 2):
+ * -1    test             1.000 x    750
+ *  0    Tiny             2.000 x  1.500
+ *  1    Small            4.000 x  3.000
+ *  2    Medium           6.000 x  4.500
+ *  3    Large            8.000 x  6.000
+ *  4    Extra Large     10.000 x  7.500
+ *  5    Huge            12.000 x  9.000
+ *
+ * Height Distribution:
+ * 5% 	space       Layer
+ * 10%	sky         Layer
+ * 5%	surface     Layer
+ * 5%	ground      Layer
+ * 10%	caves       Layer
+ * 15%	deep Caves  Layer
+ * 18%	compression Layer
+ * 5%	outer Core  Layer
+ * 15%	inner Core  Layer
+ * 2%	bedrock     Layer
+ */
+void generateWorld(const std::string worldName, int sizeTemplate, int seed, std::array<int, 4> previews, const PreviewSettings& previewSettings = {}, bool incremental = false) {
+    //-> Some Insight: https://www.youtube.com/watch?v=Pgt82G4Jxac&t=448s
+
+    JFLX::log("World Generation: ", "Generating world...", JFLX::LOGTYPE::SUCCESS);
+    generationTimings.start();
+    
+    JFLX::log("World Generation: ", "Setting Up Random Seed..", JFLX::LOGTYPE::SUCCESS);
+    GenerationRandom random(seed);
+
+    //++ Determine World Size and Smoothness
+    int sizeX, sizeY, smoothness;
+    switch (sizeTemplate) {
+        case -1:
+            sizeX       = 1000;
+            sizeY       = 750;
+            smoothness  = 32;
+            break;
+        case 0:
+            sizeX       = 2000;
+            sizeY       = 1500;
+            smoothness  = 64;
+            break;
+        case 1:
+            sizeX       = 4000;
+            sizeY       = 3000;
+            smoothness  = 64;
+            break;
+        case 2:
+            sizeX       = 6000;
+            sizeY       = 4500;
+            smoothness  = 192;
+            break;
+        case 3:
+            sizeX       = 8000;
+            sizeY       = 6000;
+            smoothness  = 256;
+            break;
+        case 4:
+            sizeX       = 10000;
+            sizeY       = 7500;
+            smoothness  = 320;
+            break;
+        case 5:
+            sizeX       = 12000;
+            sizeY       = 9000;
+            smoothness  = 384;
+            break;
+        default:
+            JFLX::log("World Generation: ", "Invalid size template specified. Using default (Medium).", JFLX::LOGTYPE::WARNING);
+            sizeX       = 6000;
+            sizeY       = 4500;
+            smoothness  = 192;
+            break;
+    }
+
+    //++ Create World Directory
+    if (!fs::exists(path + "/worlds/" + worldName)) {
+        JFLX::log("World Generation: ", "Creating World Directory.", JFLX::LOGTYPE::INFO);
+        fs::create_directories(path + "/worlds/" + worldName + "/worldData/map/");
+    } else {
+        JFLX::log("World Generation: ", "World Directory already exists. Replacing Old World Data.", JFLX::LOGTYPE::WARNING);
+    }
+
+    /*
+    ++ Create Packed Planes
+    Everything that lives until the world is saved comes first, the noise fields that are only read by one stage come last
+    (veinMap below rockMap), so each of them is released by rewinding the arena once its last consuming stage finished:
+    rockMap after "layers", veinMap after "ores". The tile planes already exist while the noise is generated, so the noise
+    step holds 9 bytes per tile (perlin, tiles, rock, vein, int scratch), every step after "ores" only holds 3.
+    */
+    JFLX::log("World Generation: ", "Creating packed planes.", JFLX::LOGTYPE::SUCCESS);
+    GenerationArena& arena = generationArena();
+    size_t tileCount = size_t(sizeX) * sizeY;
+    Plane perlinNoiseMap = makePlane(arena, sizeX, sizeY);
+    TilePlanes tileMap(arena, sizeX, sizeY);
+
+    //++ Stage Inputs (row tables, surface columns, biomes)
+    ArenaVector<uint8_t> rowLayers   = compileRowTable(generationRules.layers, sizeY, &arena);
+    ArenaVector<uint8_t> rowOreBands = compileRowTable(generationRules.oreBands, sizeY, &arena);
+    ArenaVector<SurfaceColumn> columns = computeSurfaceColumns(random, sizeX, sizeY);
+    std::vector<Biome> biomes = createBiomes(random, sizeX, sizeY);
+    const CompiledStructure* tree = findStructure(generationRules, "tree");
+
+    ArenaMarker veinMarker = arena.mark();
+    Plane veinMap          = makePlane(arena, sizeX, sizeY);
+    ArenaMarker rockMarker = arena.mark();
+    Plane rockMap          = makePlane(arena, sizeX, sizeY);
+
+    //++ Generate Perlin Noise Maps, one shared int scratch map is packed into each 8 bit plane
+    int rockSmoothness = 90+random.range(RANDOMSTAGE::NOISE, 0, 0, 10);
+    int veinSmoothness = 125+random.range(RANDOMSTAGE::NOISE, 1, 0, 10);
+
+    std::unique_ptr<StageCache> cache;
+    uint64_t noiseKey = CacheHash().add(GENERATION_CACHE_VERSION).add(seed).add(sizeX).add(sizeY).add(smoothness).add(rockSmoothness).add(veinSmoothness).value;
+    bool noiseCached = false;
+    if (incremental) {
+        cache = std::make_unique<StageCache>(path + "/worlds/" + worldName + "/worldData/cache", sizeX, sizeY);
+        noiseCached = true;
+        for (int r = 0; r < cache->regionCount() && noiseCached; ++r) {
+            noiseCached = cache->load("noise", r, noiseKey, {perlinNoiseMap.get(), rockMap.get(), veinMap.get()});
+        }
+    }
+
+    if (noiseCached) {
+        JFLX::log("World Generation: ", "Loaded Perlin noise maps from the stage cache.", JFLX::LOGTYPE::SUCCESS);
+    } else {
+        JFLX::log("World Generation: ", "Generating Perlin noise map.", JFLX::LOGTYPE::SUCCESS);
+        ArenaMarker scratch = arena.mark();
+        int* noiseScratch = arena.allocateArray<int>(tileCount);
+        JFLX::perlinNoise(noiseScratch, sizeX, sizeY, seed, smoothness);
+        packNoise(noiseScratch, perlinNoiseMap.get(), tileCount);
+        JFLX::perlinNoise(noiseScratch, sizeX, sizeY, seed, rockSmoothness);
+        packNoise(noiseScratch, rockMap.get(), tileCount);
+        JFLX::perlinNoise(noiseScratch, sizeX, sizeY, seed, veinSmoothness);
+        packNoise(noiseScratch, veinMap.get(), tileCount);
+        arena.rewind(scratch);
+
+        if (cache) {
+            for (int r = 0; r < cache->regionCount(); ++r) {
+                cache->store("noise", r, noiseKey, {perlinNoiseMap.get(), rockMap.get(), veinMap.get()});
+            }
+        }
+        JFLX::log("World Generation: ", "Completed Generating Perlin noise map.", JFLX::LOGTYPE::SUCCESS);
+    }
+    generationTimings.lap("noise");
+
+    if (previews[1] == 1) {generateAndSaveNoisePreviewImage(rockMap.get(), "rockMap", sizeX, sizeY, worldName, previewSettings);}
+    if (previews[2] == 1) {generateAndSaveNoisePreviewImage(veinMap.get(), "veinMap", sizeX, sizeY, worldName, previewSettings);}
+    generationTimings.lap("previews");
+
+    //++ Set Tiles by Layer -> Ores -> Surface -> Jungle and Ice Biome -> Trees -> Bedrock
+    std::vector<GenerationStage> stages = {
+        {"layers", true,
+            [&](int rowBegin, int rowEnd) {setTilesByLayer(tileMap, perlinNoiseMap.get(), rockMap.get(), sizeX, rowBegin, rowEnd, rowLayers);},
+            [&](int rowBegin, int rowEnd) {return hashLayerRows(rowLayers, rowBegin, rowEnd);},
+            [&]() {rockMap.reset(); arena.rewind(rockMarker);}},
+        //++ Ore veins flood across rows
+        {"ores", false,
+            [&](int rowBegin, int rowEnd) {generateOres(tileMap, veinMap.get(), sizeX, rowBegin, rowEnd, rowOreBands, random);},
+            [&](int, int) {return hashOreRules(rowOreBands);},
+            [&]() {veinMap.reset(); arena.rewind(veinMarker);}},
+        {"surface", true,
+            [&](int rowBegin, int rowEnd) {generateSurfaceLevel(tileMap, columns, sizeX, rowBegin, rowEnd);},
+            [&](int, int) {return hashSurfaceColumns(columns, false);},
+            nullptr},
+        {"biomes", true,
+            [&](int rowBegin, int rowEnd) {paintBiomes(tileMap, biomes, rowBegin, rowEnd);},
+            [&](int rowBegin, int rowEnd) {return hashBiomeRows(biomes, rowBegin, rowEnd);},
+            nullptr},
+        //++ Trees grow across rows
+        {"trees", false,
+            [&](int, int) {generateTrees(tileMap, random);},
+            [&](int, int) {return hashStructure(tree);},
+            nullptr},
+        {"bedrock", true,
+            [&](int rowBegin, int rowEnd) {generateBedrockLevel(tileMap, columns, sizeX, rowBegin, rowEnd);},
+            [&](int, int) {return hashSurfaceColumns(columns, true);},
+            nullptr},
+    };
+    runGenerationStages(stages, tileMap, cache.get(), noiseKey);
+
+    //++ Save World Data
+    JFLX::log("World Generation: ", "Saving world data (.wld).", JFLX::LOGTYPE::SUCCESS);
+
+    //++ Save World File
+    savingWoldFile(worldName, tileMap, sizeX, sizeY, seed, perlinNoiseMap.get());
+
+    JFLX::log("World Generation: ", "Saved world data (.wld).", JFLX::LOGTYPE::SUCCESS);
+    generationTimings.lap("save");
+
+    //++ Save Preview Images
+    JFLX::log("World Generation: ", "Saving Preview Image(s) (.png).", JFLX::LOGTYPE::SUCCESS);
+    if (previews[0] == 1) {generateAndSaveNoisePreviewImage(perlinNoiseMap.get(), "perlinNoise", sizeX, sizeY, worldName, previewSettings);}
+    if (previews[3] == 1) {generateAndSaveTilePreviewImage(tileMap, sizeX, sizeY, worldName, previewSettings);}
+    previewEncoder().finish();
+    generationTimings.lap("previews");
+
+    JFLX::log("World Generation: ", "World generation completed.", JFLX::LOGTYPE::SUCCESS);
+    finishWorldArena();
+    generationTimings.report(worldName);
+}
+
+/*
+++ Streamed (out-of-core) World Generation
+Generates the world band by band (rows of chunks) and writes every finished band straight into the world file.
+Only a window of two bands is held: the band that is currently generated and the finished band above it as halo.
+
+- Ore veins of the current band may flood up into the halo band, anything further is cut off at the window border.
+- Surface, biomes and bedrock are applied when a band leaves the window, so every tile sees the same stage order as in generateWorld.
+- Surface columns (height, grass depth, tree roll, bedrock height) are the same as in generateWorld.
+- Trees have to fit into the window, trees that would reach above it are dropped.
+
+Memory: 2 * bandRows * sizeX * 5 bytes plus a few ints per column, independent of the world height.
+Noise is sampled from generationNoise.hpp instead of JFLX::perlinNoise, so the world differs from generateWorld for the same seed.
+The tile preview is rendered band by band into one (downscaled) image, so use a downscale that keeps it small.
+*/
+void generateWorldStreamed(const std::string worldName, int sizeX, int sizeY, int seed, int bandChunks = 4, bool tilePreview = false, const PreviewSettings& previewSettings = {}) {
+    JFLX::log("World Generation: ", "Generating world (streamed " + std::to_string(sizeX) + "x" + std::to_string(sizeY) + ")...", JFLX::LOGTYPE::SUCCESS);
+    generationTimings.start();
+    GenerationRandom random(seed);
+
+    int smoothness = std::max(32, sizeX / 32);
+    int rockSmoothness = 90+random.range(RANDOMSTAGE::NOISE, 0, 0, 10);
+    int veinSmoothness = 125+random.range(RANDOMSTAGE::NOISE, 1, 0, 10);
+    int bandRows = std::max(1, bandChunks) * GENERATION_CHUNKSIZE;
+
+    //++ Row Tables (layer / ore band per world row) and Column Tables
+    GenerationArena& arena = generationArena();
+    ArenaVector<uint8_t> rowLayers   = compileRowTable(generationRules.layers, sizeY, &arena);
+    ArenaVector<uint8_t> rowOreBands = compileRowTable(generationRules.oreBands, sizeY, &arena);
+
+    ArenaVector<SurfaceColumn> columns = computeSurfaceColumns(random, sizeX, sizeY);
+    std::vector<Biome> biomes = createBiomes(random, sizeX, sizeY);
+
+    //++ Create World Directory
+    if (!fs::exists(path + "/worlds/" + worldName)) {
+        JFLX::log("World Generation: ", "Creating World Directory.", JFLX::LOGTYPE::INFO);
+        fs::create_directories(path + "/worlds/" + worldName + "/worldData/map/");
+    } else {
+        JFLX::log("World Generation: ", "World Directory already exists. Replacing Old World Data.", JFLX::LOGTYPE::WARNING);
+    }
+
+    std::ofstream worldFile(worldFilePath(worldName, sizeX, sizeY, seed));
+    if (!worldFile.is_open()) {
+        JFLX::log("World Generation: ", "Failed to open world file!", JFLX::LOGTYPE::ERROR);
+        arena.reset();
+        return;
+    }
+
+    //++ Sliding Window: [halo band | current band]
+    TilePlanes window(arena, sizeX, 2 * bandRows);
+    Plane perlinNoiseMap = makePlane(arena, sizeX, 2 * bandRows);
+    Plane rockMap        = makePlane(arena, sizeX, 2 * bandRows);
+    Plane veinMap        = makePlane(arena, sizeX, 2 * bandRows);
+    window.sizeY = 0;
+
+    int previewWidth  = previewSize(sizeX, previewSettings.downscale);
+    int previewHeight = previewSize(sizeY, previewSettings.downscale);
+    std::vector<uint8_t> previewImage;
+    if (tilePreview) {
+        previewImage = previewEncoder().acquireBuffer(size_t(previewWidth) * previewHeight * 3);
+    }
+
+    auto finishHaloBand = [&](int haloRows) {
+        int rowBegin = window.originY;
+        int rowEnd   = window.originY + haloRows;
+
+        generateSurfaceLevel(window, columns, sizeX, rowBegin, rowEnd);
+        generationTimings.lap("surface");
+        paintBiomes(window, biomes, rowBegin, rowEnd);
+        generationTimings.lap("biomes");
+        generateTrees(window, random);
+        generationTimings.lap("trees");
+        generateBedrockLevel(window, columns, sizeX, rowBegin, rowEnd);
+        generationTimings.lap("bedrock");
+
+        if (tilePreview) {
+            renderTilePreview(window, previewSettings.downscale, rowBegin, rowEnd, previewImage.data());
+            generationTimings.lap("previews");
+        }
+
+        //++ Write the band and slide the window up
+        writeWorldRows(worldFile, perlinNoiseMap.get(), sizeX, haloRows);
+
+        size_t haloCount = size_t(haloRows) * sizeX;
+        size_t keepCount = window.count() - haloCount;
+        for (uint8_t* plane : {window.blocks.get(), window.walls.get(), perlinNoiseMap.get(), rockMap.get(), veinMap.get()}) {
+            std::memmove(plane, plane + haloCount, keepCount);
+        }
+        window.originY += haloRows;
+        window.sizeY   -= haloRows;
+        generationTimings.lap("save");
+    };
+
+    int haloRows = 0;
+    for (int bandY = 0; bandY < sizeY; bandY += bandRows) {
+        int rows = std::min(bandRows, sizeY - bandY);
+
+        //++ Append the band below the halo
+        size_t offset = window.count();
+        window.sizeY += rows;
+        fillNoiseRows(perlinNoiseMap.get() + offset, sizeX, bandY, rows, seed, smoothness);
+        fillNoiseRows(rockMap.get() + offset, sizeX, bandY, rows, seed, rockSmoothness);
+        fillNoiseRows(veinMap.get() + offset, sizeX, bandY, rows, seed, veinSmoothness);
+        generationTimings.lap("noise");
+
+        setTilesByLayer(window, perlinNoiseMap.get(), rockMap.get(), sizeX, bandY, bandY + rows, rowLayers);
+        generationTimings.lap("layers");
+        generateOres(window, veinMap.get(), sizeX, bandY, bandY + rows, rowOreBands, random);
+        generationTimings.lap("ores");
+
+        //++ Nothing can reach the halo band anymore
+        if (haloRows > 0) {
+            finishHaloBand(haloRows);
+        }
+        haloRows = rows;
+
+        JFLX::log("World Generation: ", "Streamed rows " + std::to_string(window.originY) + " / " + std::to_string(sizeY), JFLX::LOGTYPE::INFO);
+    }
+    finishHaloBand(haloRows);
+
+    worldFile.close();
+
+    if (tilePreview) {
+        previewEncoder().submit(previewPath(worldName, "tile"), std::move(previewImage), previewWidth, previewHeight, previewSettings.tileSize);
+        previewEncoder().finish();
+        generationTimings.lap("previews");
+    }
+
+    JFLX::log("World Generation: ", "World generation completed.", JFLX::LOGTYPE::SUCCESS);
+    finishWorldArena();
+    generationTimings.report(worldName);
+}
+
+//++ One world of a run (command line or batch manifest), sizeX / sizeY > 0 select the streamed generator
+struct WorldJob {
+    std::string name;
+    int sizeTemplate = -1;
+    int seed         = 12345;
+    std::array<int, 4> previews = {0, 0, 0, 0};
+    int sizeX        = 0;
+    int sizeY        = 0;
+    int downscale    = 0;    // 0 = default of the generator (1, streamed: at most 4096 pixels)
+    int tileSize     = -1;   // -1 = default of the generator (one image, streamed: 1024 pixel tiles)
+    bool incremental = false;  // reuse the stage cache of the last run (size templates only)
+};
+
+bool parseIntArgument(const std::string& text, int& value, const std::string& what) {
+    const char* first = text.data();
+    const char* last  = text.data() + text.size();
+    auto [end, error] = std::from_chars(first, last, value);
+    if (error != std::errc() || end != last) {
+        JFLX::log("World Generation: ", "Invalid " + what + ": \"" + text + "\" is not a number.", JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    return true;
+}
+
+bool validateWorldJob(const WorldJob& job) {
+    if (job.name.empty()) {
+        JFLX::log("World Generation: ", "World name must not be empty.", JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    for (int preview : job.previews) {
+        if (preview != 0 && preview != 1) {
+            JFLX::log("World Generation: ", "Previews of " + job.name + " must be 0 or 1.", JFLX::LOGTYPE::ERROR);
+            return false;
+        }
+    }
+    if ((job.sizeX != 0 || job.sizeY != 0) && (job.sizeX < GENERATION_CHUNKSIZE || job.sizeY < GENERATION_CHUNKSIZE)) {
+        JFLX::log("World Generation: ", "Custom size of " + job.name + " must be at least " + std::to_string(GENERATION_CHUNKSIZE) + "x" + std::to_string(GENERATION_CHUNKSIZE) + ".", JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    if (job.downscale < 0 || job.tileSize < -1) {
+        JFLX::log("World Generation: ", "Preview downscale / tile size of " + job.name + " must not be negative.", JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+    return true;
+}
+
+/*
+++ Batch Manifest (.jsonc)
+{"worlds":[
+    {"name":"testWorld0", "size":0, "seed":1253425453, "previews":[0, 0, 0, 1]},
+    {"name":"tallWorld",  "sizeX":3000, "sizeY":20000, "seed":42, "previews":[0, 0, 0, 1], "downscale":8},
+    {"name":"levelTest",  "size":3, "seed":7, "incremental":true}
+]}
+Missing fields use the WorldJob defaults.
+*/
+bool loadBatchManifest(const std::string& manifestPath, std::vector<WorldJob>& jobs) {
+    std::ifstream file(manifestPath);
+    if (!file.is_open()) {
+        JFLX::log("World Generation: ", "Failed to open batch manifest " + manifestPath, JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+
+    try {
+        nlohmann::json data = nlohmann::json::parse(file, nullptr, true, true);
+        for (const auto& world : data.at("worlds")) {
+            WorldJob job;
+            job.name         = world.at("name").get<std::string>();
+            job.sizeTemplate = world.value("size", job.sizeTemplate);
+            job.seed         = world.value("seed", job.seed);
+            job.sizeX        = world.value("sizeX", job.sizeX);
+            job.sizeY        = world.value("sizeY", job.sizeY);
+            job.downscale    = world.value("downscale", job.downscale);
+            job.tileSize     = world.value("tileSize", job.tileSize);
+            job.incremental  = world.value("incremental", job.incremental);
+            if (world.contains("previews")) {
+                job.previews = world["previews"].get<std::array<int, 4>>();
+            }
+
+            if (!validateWorldJob(job)) return false;
+            jobs.push_back(job);
+        }
+    } catch (const nlohmann::json::exception& e) {
+        JFLX::log("World Generation: ", std::string("Invalid batch manifest: ") + e.what(), JFLX::LOGTYPE::ERROR);
+        return false;
+    }
+
+    JFLX::log("World Generation: ", "Loaded " + std::to_string(jobs.size()) + " world(s) from " + manifestPath, JFLX::LOGTYPE::SUCCESS);
+    return true;
+}
+
+void runWorldJob(const WorldJob& job) {
+    PreviewSettings previewSettings;
+
+    if (job.sizeX > 0 && job.sizeY > 0) {
+        //++ Streamed previews are kept at most 4096 pixels wide / high and written as 1024 pixel tiles
+        previewSettings.downscale = job.downscale > 0 ? job.downscale : std::max(1, (std::max(job.sizeX, job.sizeY) + 4095) / 4096);
+        previewSettings.tileSize  = job.tileSize >= 0 ? job.tileSize : 1024;
+
+        if (job.incremental) {
+            JFLX::log("World Generation: ", "Incremental generation is not supported for streamed worlds, generating " + job.name + " from scratch.", JFLX::LOGTYPE::WARNING);
+        }
+        if (job.previews[0] == 1 || job.previews[1] == 1 || job.previews[2] == 1) {
+            JFLX::log("World Generation: ", "Custom size given, only the tile preview is generated in streamed mode.", JFLX::LOGTYPE::WARNING);
+        }
+        generateWorldStreamed(job.name, job.sizeX, job.sizeY, job.seed, 4, job.previews[3] == 1, previewSettings);
+        return;
+    }
+
+    previewSettings.downscale = job.downscale > 0 ? job.downscale : 1;
+    previewSettings.tileSize  = job.tileSize >= 0 ? job.tileSize : 0;
+    generateWorld(job.name, job.sizeTemplate, job.seed, job.previews, previewSettings, job.incremental);
+}
+
+/*
+++ Arguments:
+ WorldGen <worldName> [sizeTemplate] [seed] [previews x4] [sizeX sizeY] [options]
+ WorldGen --batch <manifest.jsonc> [options]
+
+ worldName          (string)
+ sizeTemplate       (int, default -1)
+ seed               (int, default 12345)
+ previews           Perlin Noise Map, rock Noise Map, vein Noise Map, Tile Map (bool) 0 / false, 1 / true, default 0
+ sizeX sizeY        custom size (int) -> generates the world streamed (out-of-core), only the tile preview is written (downscaled, tiled)
+
+ options:
+ --batch <file>     generates every world of the manifest in this process (see loadBatchManifest)
+ --downscale <n>    previews use every n-th tile
+ --tile-size <n>    previews are split into n x n pixel PNG tiles, 0 = one image
+ --incremental      keeps the output of every stage in worldData/cache and only generates the stages (and regions) whose parameters changed
+*/
+int main(int argc, char* argv[]) {
+    const std::string usage = "Usage: <worldName> [sizeTemplate] [seed] [preview Perlin Noise Map] [preview rock Noise Map] [preview vein Noise Map] [preview Tile Map] [sizeX sizeY] [--downscale n] [--tile-size n] [--incremental] | --batch <manifest.jsonc>";
+
+    std::string combined;
+    for (int i = 0; i < argc; ++i) {
+        combined += argv[i];
+        if (i < argc - 1) combined += ", ";
+    }
+
+    JFLX::log("World Generation: ", "Running: " + combined, JFLX::LOGTYPE::SUCCESS);
+
+    //++ Split options and positional arguments
+    std::string manifestPath;
+    int downscale = 0;
+    int tileSize  = -1;
+    bool incremental = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (argument == "--batch" && hasValue) {
+            manifestPath = argv[++i];
+        } else if (argument == "--downscale" && hasValue) {
+            if (!parseIntArgument(argv[++i], downscale, "downscale")) return 1;
+        } else if (argument == "--tile-size" && hasValue) {
+            if (!parseIntArgument(argv[++i], tileSize, "tile size")) return 1;
+        } else if (argument == "--incremental") {
+            incremental = true;
+        } else if (argument.rfind("--", 0) == 0) {
+            JFLX::log("World Generation: ", "Unknown or incomplete option " + argument + ". " + usage, JFLX::LOGTYPE::ERROR);
+            return 1;
+        } else {
+            positional.push_back(argument);
+        }
+    }
+
+    std::vector<WorldJob> jobs;
+    if (!manifestPath.empty()) {
+        if (!positional.empty()) {
+            JFLX::log("World Generation: ", "--batch does not take positional arguments. " + usage, JFLX::LOGTYPE::ERROR);
+            return 1;
+        }
+        if (!loadBatchManifest(manifestPath, jobs)) return 1;
+    } else {
+        size_t count = positional.size();
+        if (count < 1 || (count > 3 && count != 7 && count != 9)) {
+            JFLX::log("World Generation: ", "Wrong number of arguments. " + usage, JFLX::LOGTYPE::ERROR);
+            return 1;
+        }
+
+        WorldJob job;
+        job.name = positional[0];
+        if (count > 1 && !parseIntArgument(positional[1], job.sizeTemplate, "size template")) return 1;
+        if (count > 2 && !parseIntArgument(positional[2], job.seed, "seed")) return 1;
+        for (size_t i = 3; i < std::min<size_t>(count, 7); ++i) {
+            if (!parseIntArgument(positional[i], job.previews[i - 3], "preview flag")) return 1;
+        }
+        if (count == 9) {
+            if (!parseIntArgument(positional[7], job.sizeX, "sizeX")) return 1;
+            if (!parseIntArgument(positional[8], job.sizeY, "sizeY")) return 1;
+        }
+        jobs.push_back(job);
+    }
+
+    for (WorldJob& job : jobs) {
+        if (downscale > 0) job.downscale = downscale;
+        if (tileSize >= 0) job.tileSize = tileSize;
+        if (incremental) job.incremental = true;
+        if (!validateWorldJob(job)) return 1;
+    }
+
+    if (!loadGenerationRules(path + "gameData/json/generationRules.jsonc", generationRules)) {
+        JFLX::log("World Generation: ", "Could not load the generation rules! Can not continue Generation!", JFLX::LOGTYPE::ERROR);
+        return 1;
+    }
+
+    //++ All worlds share the worker pool and the preview encoder
+    std::vector<std::pair<std::string, double>> worldTimes;
+    for (const WorldJob& job : jobs) {
+        runWorldJob(job);
+        worldTimes.push_back({job.name, generationTimings.totalMilliseconds()});
+    }
+
+    if (jobs.size() > 1) {
+        JFLX::log("World Generation: ", "Batch finished:", JFLX::LOGTYPE::SUCCESS);
+        for (const auto& [name, milliseconds] : worldTimes) {
+            JFLX::log("World Generation: ", "  " + name + ": " + std::to_string(int64_t(milliseconds)) + " ms", JFLX::LOGTYPE::INFO);
+        }
+    }
+
+    return 0;
+}
@@ -1,12 +1,6 @@
 @echo off
 
-WorldGen.exe "testWorld-1" -1 1253425453
-WorldGen.exe "testWorld0"   0 1253425453
-WorldGen.exe "testWorld1"   1 1253425453
-WorldGen.exe "testWorld2"   2 1253425453
-WorldGen.exe "testWorld3"   3 1253425453
-WorldGen.exe "testWorld4"   4 1253425453
-WorldGen.exe "testWorld5"   5 1253425453
+WorldGen.exe --batch "%~dp0testWorlds.jsonc"
 
 echo Done!
 pause